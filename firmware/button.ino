@@ -6,51 +6,197 @@ Copyright (C) 2018 FastyBird s.r.o. <code@fastybird.com>
 
 */
 
-// -----------------------------------------------------------------------------
-// MODULE PRIVATE
-// -----------------------------------------------------------------------------
+#if BUTTON_MAX_ITEMS
 
 #include "config/all.h"
 
 #include <Arduino.h>
 
-#if !defined(ARDUINO_ARCH_SAM) && !defined(ARDUINO_ARCH_SAMD) && !defined(ARDUINO_ARCH_STM32F2)
-    #include <EEPROM.h>
-#else
-    #include <../lib/ArmEeprom/Samd21Eeprom.h>
+#if BUTTON_MAX_ITEMS > 16
+    #error "Button module supports up to 16 buttons"
 #endif
 
-uint8_t _buttonMapEvent(
-    const uint8_t event,
+// Input ports used by buttons, each port is read once per sample
+uint8_t _button_ports[BUTTON_MAX_ITEMS];
+uint8_t _button_ports_count = 0;
+
+uint8_t _button_port_index[BUTTON_MAX_ITEMS];   // Index of button port in ports list
+uint8_t _button_port_bit[BUTTON_MAX_ITEMS];     // Position of button pin in port register
+
+// Debounce engine, one bit per button, set bit => pressed
+uint16_t _button_status = 0;                    // Debounced
+uint16_t _button_counter_low = 0;               // Vertical counter, low bits
+uint16_t _button_counter_high = 0;              // Vertical counter, high bits
+
+uint32_t _button_last_sample = 0;
+
+// Clicks state machine
+uint16_t _button_click_pending = 0;             // Released buttons waiting for next click or clicks timeout
+uint16_t _button_click_finished = 0;            // Buttons which reported clicks event, event is cleared with next sample
+
+uint8_t _button_click_count[BUTTON_MAX_ITEMS];
+uint32_t _button_click_start[BUTTON_MAX_ITEMS];
+uint16_t _button_click_length[BUTTON_MAX_ITEMS];
+
+// -----------------------------------------------------------------------------
+// MODULE PRIVATE
+// -----------------------------------------------------------------------------
+
+void _buttonConfigure()
+{
+    for (uint8_t i = 0; i < BUTTON_MAX_ITEMS; i++) {
+        _button_port_index[i] = INDEX_NONE;
+        _button_click_count[i] = 0;
+
+        pinMode(button_module_items[i].pin, INPUT_PULLUP);
+
+        uint8_t port = digitalPinToPort(button_module_items[i].pin);
+
+        // Pin without digital input, e.g. analog only pin
+        if (port == NOT_A_PORT) {
+            continue;
+        }
+
+        uint32_t mask = digitalPinToBitMask(button_module_items[i].pin);
+
+        _button_port_bit[i] = 0;
+
+        while ((mask >> _button_port_bit[i]) > 1) {
+            _button_port_bit[i]++;
+        }
+
+        for (uint8_t j = 0; j < _button_ports_count; j++) {
+            if (_button_ports[j] == port) {
+                _button_port_index[i] = j;
+            }
+        }
+
+        if (_button_port_index[i] == INDEX_NONE) {
+            _button_port_index[i] = _button_ports_count;
+            _button_ports[_button_ports_count++] = port;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Read all used ports at once and collect buttons states
+ *
+ * @return Mask of pressed buttons
+ */
+uint16_t _buttonReadInputs()
+{
+    uint32_t ports[BUTTON_MAX_ITEMS] = {0};
+
+    for (uint8_t j = 0; j < _button_ports_count; j++) {
+        ports[j] = *portInputRegister(_button_ports[j]);
+    }
+
+    uint16_t pressed = 0;
+
+    for (uint8_t i = 0; i < BUTTON_MAX_ITEMS; i++) {
+        // Input is pulled up, pressed button is pulling it to ground
+        if (_button_port_index[i] != INDEX_NONE && ((ports[_button_port_index[i]] >> _button_port_bit[i]) & 1) == 0) {
+            pressed |= (1U << i);
+        }
+    }
+
+    return pressed;
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Debounce all buttons in parallel with 2 bit vertical counters
+ * Counter of each button is running while its input differs from debounced state,
+ * debounced state is toggled after 4 consecutive samples
+ *
+ * @return Mask of buttons with changed debounced state
+ */
+uint16_t _buttonDebounce(
+    const uint16_t inputs
+) {
+    uint16_t delta = inputs ^ _button_status;
+
+    _button_counter_high = (_button_counter_high ^ _button_counter_low) & delta;
+    _button_counter_low = ~_button_counter_low & delta;
+
+    uint16_t toggle = delta & ~(_button_counter_low | _button_counter_high);
+
+    _button_status ^= toggle;
+
+    return toggle;
+}
+
+// -----------------------------------------------------------------------------
+
+uint8_t _buttonMapClick(
     const uint8_t count,
     const uint16_t length
 ) {
-    if (event == EVENT_PRESSED) {
-        return BUTTON_EVENT_PRESSED;
+    if (count == 1) {
+        if (length >= BUTTON_LNGLNGCLICK_DELAY) {
+            return BUTTON_EVENT_LNGLNGCLICK;
+
+        } else if (length >= BUTTON_LNGCLICK_DELAY) {
+            return BUTTON_EVENT_LNGCLICK;
+        }
 
-    } else if (event == EVENT_CHANGED) {
         return BUTTON_EVENT_CLICK;
 
-    } else if (event == EVENT_RELEASED) {
-        if (count == 1) {
-            if (length >= BUTTON_LNGLNGCLICK_DELAY) {
-                return BUTTON_EVENT_LNGLNGCLICK;
+    } else if (count == 2) {
+        return BUTTON_EVENT_DBLCLICK;
 
-            } else if (length >= BUTTON_LNGCLICK_DELAY) {
-                return BUTTON_EVENT_LNGCLICK;
-            }
+    } else if (count == 3) {
+        return BUTTON_EVENT_TRIPLECLICK;
+    }
+
+    return BUTTON_EVENT_RELEASED;
+}
+
+// -----------------------------------------------------------------------------
 
-            return BUTTON_EVENT_CLICK;
+/**
+ * Clicks state machine step of one button
+ *
+ * @return Button event
+ */
+uint8_t _buttonProcess(
+    const uint8_t id,
+    const uint16_t changed
+) {
+    uint16_t mask = 1U << id;
 
-        } else if (count == 2) {
-            return BUTTON_EVENT_DBLCLICK;
+    if (changed & mask) {
+        // Pressed
+        if (_button_status & mask) {
+            if (_button_click_count[id] < 0xFF) {
+                _button_click_count[id]++;
+            }
 
-        } else if (count == 3) {
-            return BUTTON_EVENT_TRIPLECLICK;
+            _button_click_start[id] = millis();
+            _button_click_pending &= ~mask;
 
-        } else {
-            return BUTTON_EVENT_RELEASED;
+            return BUTTON_EVENT_PRESSED;
         }
+
+        // Released
+        uint32_t length = millis() - _button_click_start[id];
+
+        _button_click_length[id] = length > 0xFFFF ? 0xFFFF : length;
+        _button_click_pending |= mask;
+    }
+
+    // No other click came in time, clicks sequence is finished
+    if ((_button_click_pending & mask) && (millis() - _button_click_start[id]) > BUTTON_DBLCLICK_DELAY) {
+        uint8_t event = _buttonMapClick(_button_click_count[id], _button_click_length[id]);
+
+        _button_click_pending &= ~mask;
+        _button_click_finished |= mask;
+        _button_click_count[id] = 0;
+
+        return event;
     }
 
     return BUTTON_EVENT_NONE;
@@ -77,10 +223,7 @@ void _buttonEvent(
     button_module_items[id].current_status = event;
 
     #if DEBUG_SUPPORT
-        DPRINT(F("[BUTTON] Button #"));
-        DPRINT(id);
-        DPRINT(F(" event "));
-        DPRINTLN(event);
+        DLOG(LOG_BUTTON_EVENT, id, event);
     #endif
 
     #if REGISTER_MAX_INPUT_REGISTERS_SIZE
@@ -108,7 +251,7 @@ void _buttonEvent(
 
                 case BUTTON_EVENT_LNGCLICK:
                     #if DEBUG_SUPPORT
-                        DPRINTLN(F("[BUTTON] Activating pairing mode"));
+                        DLOG(LOG_BUTTON_PAIRING_MODE);
                     #endif
 
                     firmwareSetDiscoverable(true);
@@ -116,13 +259,11 @@ void _buttonEvent(
 
                 case BUTTON_EVENT_LNGLNGCLICK:
                     #if DEBUG_SUPPORT
-                        DPRINTLN(F("[BUTTON] Clearing EEPROM"));
+                        DLOG(LOG_BUTTON_CLEARING_EEPROM);
                     #endif
 
                     // Clear stored values to factory settings
-                    for (uint8_t i = 0 ; i < EEPROM.length() ; i++) {
-                        EEPROM.write(i, 0);
-                    }
+                    registerClearStorage();
                     break;
 
             }
@@ -136,9 +277,14 @@ void _buttonEvent(
 
 void buttonSetup()
 {
+    _buttonConfigure();
+
+    // Buttons held on boot are not reported as pressed
+    _button_status = _buttonReadInputs();
+    _button_last_sample = millis();
+
     #if DEBUG_SUPPORT
-        DPRINT(F("[BUTTON] Number of buttons: "));
-        DPRINTLN(BUTTON_MAX_ITEMS);
+        DLOG(LOG_BUTTON_ITEMS, BUTTON_MAX_ITEMS);
     #endif
 }
 
@@ -146,13 +292,22 @@ void buttonSetup()
 
 void buttonLoop()
 {
-    for (uint8_t i = 0; i < BUTTON_MAX_ITEMS; i++) {
-        uint8_t event = button_module_items[i].button->loop();
-        uint8_t count = button_module_items[i].button->getEventCount();
-        unsigned long length = button_module_items[i].button->getEventLength();
+    if ((millis() - _button_last_sample) < BUTTON_DEBOUNCE_SAMPLE_INTERVAL) {
+        return;
+    }
+
+    _button_last_sample = millis();
 
-        uint8_t mapped = _buttonMapEvent(event, count, length);
+    uint16_t changed = _buttonDebounce(_buttonReadInputs());
 
-        _buttonEvent(i, mapped);
+    if (changed == 0 && _button_click_pending == 0 && _button_click_finished == 0) {
+        return;
+    }
+
+    _button_click_finished = 0;
+
+    for (uint8_t i = 0; i < BUTTON_MAX_ITEMS; i++) {
+        _buttonEvent(i, _buttonProcess(i, changed));
     }
 }
+#endif // BUTTON_MAX_ITEMS
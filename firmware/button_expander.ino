@@ -1,4 +1,3 @@
-
 /*
 
 BUTTON EXPANDER MODULE
@@ -18,68 +17,118 @@ Copyright (C) 2018 FastyBird s.r.o. <code@fastybird.com>
 Adafruit_MCP23017 mcp;
 
 #define EXPANDER_ADDRESS        0x20
-#define EXPANDER_INPUTS         16
 
-bool _expander_status[EXPANDER_INPUTS];
-bool _expander_ready[EXPANDER_INPUTS];
-bool _expander_reset_count[EXPANDER_INPUTS];
+// Inputs states, one bit per input, set bit => pressed
+uint16_t _expander_inputs = 0;          // Last read from expander
+uint16_t _expander_status = 0;          // Debounced
+
+uint32_t _expander_inputs_change[BUTTON_EXPANDER_INPUTS];   // Time of last change of each read input
+uint32_t _expander_last_read = 0;
 
-uint32_t _expander_event_start[EXPANDER_INPUTS];
-uint32_t _expander_event_length[EXPANDER_INPUTS];
-uint8_t _expander_event_count[EXPANDER_INPUTS];
+uint16_t _expander_ready = 0;
+uint16_t _expander_reset_count = 0xFFFF;
 
-uint8_t _expander_communication_register_address[EXPANDER_INPUTS];
+uint32_t _expander_event_start[BUTTON_EXPANDER_INPUTS];
+uint32_t _expander_event_length[BUTTON_EXPANDER_INPUTS];
+uint8_t _expander_event_count[BUTTON_EXPANDER_INPUTS];
 
 // -----------------------------------------------------------------------------
 // MODULE PRIVATE
 // -----------------------------------------------------------------------------
 
-uint8_t _expanderButtonRead(
-    uint8_t pin
-) {
-    uint8_t event = BUTTON_EVENT_NONE;
+/**
+ * Read all inputs in one transaction, buttons are pulling inputs to ground
+ */
+uint16_t _expanderReadInputs()
+{
+    return ~mcp.readGPIOAB();
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Read expander when it signals a change and debounce each input separately
+ * Input has to be stable for debounce delay to be accepted, other inputs are not affecting it
+ *
+ * @return Mask of inputs which debounced state was changed
+ */
+uint16_t _expanderScan()
+{
+    #if BUTTON_EXPANDER_INT_PIN != GPIO_NONE
+        // Interrupt line is held low until inputs are read
+        bool read = digitalRead(BUTTON_EXPANDER_INT_PIN) == LOW;
+    #else
+        bool read = (millis() - _expander_last_read) >= BUTTON_EXPANDER_POLL_INTERVAL;
+    #endif
+
+    if (read) {
+        uint16_t inputs = _expanderReadInputs();
 
-    //digitalWrite((13 + 0), _expanderReadPin(1));
+        _expander_last_read = millis();
 
-    if (_expanderReadPin(pin) != _expander_status[pin]) {
-        // Debounce
-        uint32_t start = millis();
+        uint16_t toggled = inputs ^ _expander_inputs;
 
-        while (millis() - start < BUTTON_DEBOUNCE_DELAY) {
-            delay(1);
+        for (uint8_t i = 0; i < BUTTON_EXPANDER_INPUTS && toggled; i++) {
+            if (toggled & (1U << i)) {
+                _expander_inputs_change[i] = _expander_last_read;
+            }
         }
 
-        if (_expanderReadPin(pin) != _expander_status[pin]) {
-            _expander_status[pin] = !_expander_status[pin];
+        _expander_inputs = inputs;
+    }
 
-            // Released
-            if (_expander_status[pin] == false) {
-                _expander_event_length[pin] = millis() - _expander_event_start[pin];
-                _expander_ready[pin] = true;
+    uint16_t pending = _expander_inputs ^ _expander_status;
+    uint16_t changed = 0;
 
-            // Pressed
-            } else {
-                event = BUTTON_EVENT_PRESSED;
+    for (uint8_t i = 0; i < BUTTON_EXPANDER_INPUTS && pending; i++) {
+        if ((pending & (1U << i)) && (millis() - _expander_inputs_change[i]) >= BUTTON_DEBOUNCE_DELAY) {
+            changed |= (1U << i);
+        }
+    }
+
+    _expander_status ^= changed;
 
-                _expander_event_start[pin] = millis();
-                _expander_event_length[pin] = 0;
+    return changed;
+}
+
+// -----------------------------------------------------------------------------
 
-                if (_expander_reset_count[pin]) {
-                    _expander_event_count[pin] = 1;
-                    _expander_reset_count[pin] = false;
+uint8_t _expanderButtonRead(
+    const uint8_t pin,
+    const uint16_t changed
+) {
+    uint8_t event = BUTTON_EVENT_NONE;
 
-                } else {
-                    ++_expander_event_count[pin];
-                }
+    uint16_t mask = 1U << pin;
 
-                _expander_ready[pin] = false;
+    if (changed & mask) {
+        // Released
+        if ((_expander_status & mask) == 0) {
+            _expander_event_length[pin] = millis() - _expander_event_start[pin];
+            _expander_ready |= mask;
+
+        // Pressed
+        } else {
+            event = BUTTON_EVENT_PRESSED;
+
+            _expander_event_start[pin] = millis();
+            _expander_event_length[pin] = 0;
+
+            if (_expander_reset_count & mask) {
+                _expander_event_count[pin] = 1;
+                _expander_reset_count &= ~mask;
+
+            } else {
+                ++_expander_event_count[pin];
             }
+
+            _expander_ready &= ~mask;
         }
     }
 
-    if (_expander_ready[pin] && (millis() - _expander_event_start[pin] > BUTTON_DBLCLICK_DELAY)) {
-        _expander_ready[pin] = false;
-        _expander_reset_count[pin] = true;
+    if ((_expander_ready & mask) && (millis() - _expander_event_start[pin] > BUTTON_DBLCLICK_DELAY)) {
+        _expander_ready &= ~mask;
+        _expander_reset_count |= mask;
 
         event = BUTTON_EVENT_RELEASED;
     }
@@ -130,55 +179,55 @@ void _expanderButtonEvent(
 ) {
     uint8_t mapped_event = _expanderButtonMapEvent(event, _expander_event_count[id], _expander_event_length[id]);
 
-    if (id >= EXPANDER_INPUTS || mapped_event == 0) {
+    if (id >= BUTTON_EXPANDER_INPUTS || mapped_event == 0) {
         return;
     }
 
     #if DEBUG_SUPPORT
-        DPRINT(F("[EXPANDER] Button #"));
-        DPRINT(id);
-        DPRINT(F(" event "));
-        DPRINTLN(mapped_event);
+        DLOG(LOG_EXPANDER_EVENT, id, mapped_event);
     #endif
 
     uint8_t communication_mapped_event = event;
 
     // Store state into communication register
-    registerWriteRegister(REGISTER_TYPE_INPUT, _expander_communication_register_address[id], communication_mapped_event);
-}
-
-// -----------------------------------------------------------------------------
-
-bool _expanderReadPin(
-    const uint8_t pin
-) {
-    return !mcp.digitalRead(pin);
+    registerWriteRegister(REGISTER_TYPE_INPUT, deviceExpanderRegisterAddress(id), communication_mapped_event);
 }
 
 // -----------------------------------------------------------------------------
-// 
+//
 // -----------------------------------------------------------------------------
 
 void expanderSetup()
 {
     mcp.begin();
 
-    for (uint8_t i = 0; i < EXPANDER_INPUTS; i++) {
+    for (uint8_t i = 0; i < BUTTON_EXPANDER_INPUTS; i++) {
         mcp.pinMode(i, INPUT);
         mcp.pullUp(i, HIGH);  // Turn on a 100K pullup internally
 
-        _expander_status[i] = false;
         _expander_event_count[i] = 0;
-        _expander_ready[i] = false;
-        _expander_reset_count[i] = true;
-
-        // Reserve address in register
-        _expander_communication_register_address[i] = 0;
+        _expander_inputs_change[i] = 0;
     }
 
+    #if BUTTON_EXPANDER_INT_PIN != GPIO_NONE
+        // INTA & INTB mirrored, open drain, active low
+        mcp.setupInterrupts(true, true, LOW);
+
+        for (uint8_t i = 0; i < BUTTON_EXPANDER_INPUTS; i++) {
+            mcp.setupInterruptPin(i, CHANGE);
+        }
+
+        pinMode(BUTTON_EXPANDER_INT_PIN, INPUT_PULLUP);
+    #endif
+
+    // Initial read clears pending interrupt, inputs held on boot are not reported as pressed
+    _expander_inputs = _expanderReadInputs();
+    _expander_status = _expander_inputs;
+
+    _expander_last_read = millis();
+
     #if DEBUG_SUPPORT
-        DPRINT(F("[EXPANDER] Number of buttons: "));
-        DPRINTLN(EXPANDER_INPUTS);
+        DLOG(LOG_EXPANDER_ITEMS, BUTTON_EXPANDER_INPUTS);
     #endif
 }
 
@@ -186,10 +235,17 @@ void expanderSetup()
 
 void expanderLoop()
 {
-    for (uint8_t i = 0; i < EXPANDER_INPUTS; i++) {
-        if (uint8_t event = _expanderButtonRead(i)) {
+    uint16_t changed = _expanderScan();
+
+    // Nothing to process until some input is changed or waits for clicks timeout
+    if (changed == 0 && _expander_ready == 0) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < BUTTON_EXPANDER_INPUTS; i++) {
+        if (uint8_t event = _expanderButtonRead(i, changed)) {
             _expanderButtonEvent(i, event);
         }
     }
 }
-#endif // BUTTON_EXPANDER_SUPPORT
\ No newline at end of file
+#endif // BUTTON_EXPANDER_SUPPORT
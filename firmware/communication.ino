@@ -26,38 +26,314 @@ uint32_t _communication_master_last_request = 0;
 bool _communication_master_lost = false;
 bool _communication_initial_state_to_master = false;
 
-char _communication_output_buffer[PJON_PACKET_MAX_LENGTH];
+// Outgoing frame, protocol version byte is followed by packet written by handlers
+char _communication_output_frame[PJON_PACKET_MAX_LENGTH];
+
+char * const _communication_output_buffer = &_communication_output_frame[1];
+
+// Registers waiting to be reported to master, one bit per register
+#define COMMUNICATION_REPORT_OUTBOX_SIZE    ((REGISTER_MAX_INPUT_REGISTERS_SIZE + REGISTER_MAX_OUTPUT_REGISTERS_SIZE + REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE + 7) / 8)
+
+uint8_t _communication_report_outbox[COMMUNICATION_REPORT_OUTBOX_SIZE];
+
+// Registers of last report waiting for master acknowledge, only one report is in flight
+uint8_t _communication_report_inflight[COMMUNICATION_REPORT_OUTBOX_SIZE];
+
+uint8_t _communication_report_sequence = 0;
+uint8_t _communication_report_retries = 0;
+
+uint32_t _communication_report_sent = 0;
+uint32_t _communication_report_backoff = COMMUNICATION_REPORT_ACK_TIMEOUT;
+
+// Registers ranges subscribed by master & last reported registers values
+communication_subscription_t _communication_subscriptions[COMMUNICATION_SUBSCRIPTIONS_SIZE];
+
+uint8_t _communication_reported_values[DEVICE_REGISTERS_SIZE][4];
+
+// Discovery reply waiting for its slot
+bool _communication_discover_pending = false;
+bool _communication_discover_acknowledged = false;     // Master addressed device by its SN
+
+uint32_t _communication_discover_request = 0;
+uint32_t _communication_discover_delay = 0;
+
+#if COMMUNICATION_BAUDRATE_SUPPORT
+    uint32_t _communication_baudrate = COMMUNICATION_SERIAL_BAUDRATE;
+    uint32_t _communication_baudrate_requested = 0;     // Baudrate waiting to be applied after write reply is sent
+    uint32_t _communication_baudrate_changed = 0;
+#endif
+
+#if COMMUNICATION_CAPTURE_SUPPORT
+    // Captured frames waiting for serial port, records are turned into text lines while they are sent
+    uint8_t _communication_capture_buffer[COMMUNICATION_CAPTURE_BUFFER_SIZE];
+
+    uint16_t _communication_capture_head = 0;
+    uint16_t _communication_capture_tail = 0;
+    uint16_t _communication_capture_used = 0;
+
+    uint32_t _communication_capture_dropped = 0;
+
+    // Line being written to serial port, frame bytes are taken from buffer as they are written
+    char _communication_capture_line_header[COMMUNICATION_CAPTURE_LINE_HEADER_SIZE];
+
+    uint8_t _communication_capture_line_header_length = 0;
+    uint16_t _communication_capture_line_length = 0;    // 0 => No line in progress
+    uint16_t _communication_capture_line_position = 0;
+#endif
 
 // -----------------------------------------------------------------------------
 // MODULE PRIVATE
 // -----------------------------------------------------------------------------
 
-void _communicationReplyWithException(
-    uint8_t * payload
+/**
+ * Address written by master is applied after device reboot
+ */
+void _communicationAddressChanged(
+    const uint8_t type,
+    const uint8_t address
+) {
+    if (firmwareIsBooting()) {
+        return;
+    }
+
+    uint8_t device_address;
+
+    registerReadRegister(REGISTER_TYPE_ATTRIBUTE, COMMUNICATION_ATTR_REGISTER_ADDR_ADDRESS, device_address);
+
+    // Update communication address
+    communicationSetAddress(device_address);
+
+    // ...after address is stored, reload device
+    firmwareSetReboot();
+}
+
+#if COMMUNICATION_BAUDRATE_SUPPORT
+
+// -----------------------------------------------------------------------------
+// BUS BAUDRATE
+// -----------------------------------------------------------------------------
+
+/**
+ * Only standard rates could be negotiated, so all devices on the bus could agree on one
+ */
+bool _communicationIsBaudrateSupported(
+    const uint32_t baudrate
+) {
+    if (baudrate > COMMUNICATION_SERIAL_MAX_BAUDRATE) {
+        return false;
+    }
+
+    switch (baudrate)
+    {
+        case 38400:
+        case 57600:
+        case 115200:
+        case 250000:
+        case 500000:
+        case 1000000:
+            return true;
+    }
+
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+
+void _communicationSerialBegin(
+    const uint32_t baudrate
+) {
+    #if COMMUNICATION_BUS_HARDWARE_SERIAL
+        #if defined(ARDUINO_ARCH_SAM) || defined(ARDUINO_ARCH_SAMD) || defined(ARDUINO_ARCH_STM32F2)
+            Serial1.flush();
+            Serial1.begin(baudrate);
+        #else
+            Serial.flush();
+            Serial.begin(baudrate);
+        #endif
+    #else
+        _communication_serial_bus.begin((uint16_t) baudrate);
+    #endif
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * New baudrate is applied with delay, so reply to master write is still sent with actual one
+ */
+void _communicationBaudrateChanged(
+    const uint8_t type,
+    const uint8_t address
+) {
+    if (firmwareIsBooting()) {
+        return;
+    }
+
+    uint32_t baudrate;
+
+    registerReadRegister(REGISTER_TYPE_ATTRIBUTE, COMMUNICATION_ATTR_REGISTER_BAUDRATE_ADDRESS, baudrate);
+
+    if (baudrate == _communication_baudrate && _communication_baudrate_requested == 0) {
+        return;
+    }
+
+    _communication_baudrate_requested = baudrate;
+    _communication_baudrate_changed = millis();
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Apply requested baudrate & restore default one when master is not heard after switch
+ */
+void _communicationBaudrateHandle()
+{
+    if (_communication_baudrate_requested != 0) {
+        if ((millis() - _communication_baudrate_changed) < COMMUNICATION_BAUDRATE_SWITCH_DELAY) {
+            return;
+        }
+
+        _communicationSerialBegin(_communication_baudrate_requested);
+
+        _communication_baudrate = _communication_baudrate_requested;
+        _communication_baudrate_requested = 0;
+        _communication_baudrate_changed = millis();
+
+        #if DEBUG_COMMUNICATION_SUPPORT
+            DLOG(LOG_COMMUNICATION_BAUDRATE_SWITCHED, _communication_baudrate);
+        #endif
+
+        return;
+    }
+
+    if (
+        _communication_baudrate != COMMUNICATION_SERIAL_BAUDRATE
+        && (millis() - _communication_baudrate_changed) > COMMUNICATION_BAUDRATE_FALLBACK_TIMEOUT
+        && (millis() - _communication_master_last_request) > COMMUNICATION_BAUDRATE_FALLBACK_TIMEOUT
+    ) {
+        #if DEBUG_COMMUNICATION_SUPPORT
+            DLOG(LOG_COMMUNICATION_BAUDRATE_FALLBACK, _communication_baudrate);
+        #endif
+
+        // Register is updated too, so master could read actual baudrate
+        registerWriteRegister(REGISTER_TYPE_ATTRIBUTE, COMMUNICATION_ATTR_REGISTER_BAUDRATE_ADDRESS, (uint32_t) COMMUNICATION_SERIAL_BAUDRATE, false);
+    }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Check values of attribute registers which are accepting only limited set of values
+ */
+bool _communicationIsAttributeValueAccepted(
+    const word registerAddress,
+    const uint8_t * value
 ) {
-    memset(_communication_output_buffer, 0, PJON_PACKET_MAX_LENGTH);
+    #if COMMUNICATION_BAUDRATE_SUPPORT
+        if (registerAddress == COMMUNICATION_ATTR_REGISTER_BAUDRATE_ADDRESS) {
+            uint32_t baudrate;
+
+            memcpy(&baudrate, value, 4);
+
+            return _communicationIsBaudrateSupported(baudrate);
+        }
+    #endif
+
+    #if RELAY_SCENES_SUPPORT
+        if (
+            registerAddress >= RELAY_SCENES_ATTR_REGISTER_START
+            && registerAddress < RELAY_SCENES_ATTR_REGISTER_START + RELAY_SCENES_SIZE
+        ) {
+            uint32_t definition;
+
+            memcpy(&definition, value, 4);
+
+            // Scene could not contain output registers which are not present
+            return ((uint16_t) definition & (uint16_t) (0xFFFFUL << REGISTER_MAX_OUTPUT_REGISTERS_SIZE)) == 0;
+        }
+    #endif
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
 
+void _communicationReplyWithException(
+    uint8_t * payload,
+    const uint8_t code
+) {
     // 0 => Packet identifier
     // 1 => Packet identifier when exception was rised
     // 2 => Exception code
     _communication_output_buffer[0] = (char) COMMUNICATION_PACKET_EXCEPTION;
     _communication_output_buffer[1] = (char) payload[0];
-    _communication_output_buffer[2] = 0; // TODO: implement code
+    _communication_output_buffer[2] = (char) code;
 
     #if DEBUG_COMMUNICATION_SUPPORT
         // Reply to master
         if (_communicationReplyToPacket(_communication_output_buffer, 3) == false) {
             // Device was not able to notify master about its address
-            DPRINTLN(F("[COMMUNICATION][ERR] Master could not receive exception"));
+            DLOG(LOG_COMMUNICATION_EXCEPTION_NOT_RECEIVED, code);
 
         } else {
-            DPRINTLN(F("[COMMUNICATION] Replied to master with exception"));
+            DLOG(LOG_COMMUNICATION_EXCEPTION_REPLIED, code);
         }
     #else
         _communicationReplyToPacket(_communication_output_buffer, 3);
     #endif
 }
 
+// -----------------------------------------------------------------------------
+
+/**
+ * Broadcasted packets are addressed by device SN placed after packet identifier
+ * Master knows device SN only from discovery, so device is acknowledged by master
+ *
+ * 0    => Received packet identifier
+ * 1    => Device SN length
+ * 2-n  => Device SN                        => (a,b,c,...)
+ * n+1  => Packet data
+ *
+ * @param dataLength Minimal length of packet without device SN
+ * @param byteOffset Position shift of packet data
+ */
+bool _communicationIsAddressedBySerialNumber(
+    uint8_t * payload,
+    const uint16_t length,
+    const uint8_t dataLength,
+    uint8_t &byteOffset
+) {
+    // Extract device SN length
+    uint8_t device_sn_length = (uint8_t) payload[1];
+
+    if (length < (uint16_t) (device_sn_length + dataLength + 1)) {
+        #if DEBUG_COMMUNICATION_SUPPORT
+            DLOG(LOG_COMMUNICATION_BROADCAST_TOO_SHORT);
+        #endif
+
+        return false;
+    }
+
+    // Received SN is compared in place, it is not terminated in payload
+    if (
+        device_sn_length != strlen(DEVICE_SERIAL_NO)
+        || memcmp(&payload[2], DEVICE_SERIAL_NO, device_sn_length) != 0
+    ) {
+        #if DEBUG_COMMUNICATION_SUPPORT
+            DLOG(LOG_COMMUNICATION_OTHER_DEVICE);
+        #endif
+
+        return false;
+    }
+
+    byteOffset = device_sn_length + 1;
+
+    _communication_discover_acknowledged = true;
+
+    return true;
+}
+
 #if REGISTER_MAX_OUTPUT_REGISTERS_SIZE || REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
 
 // -----------------------------------------------------------------------------
@@ -65,77 +341,128 @@ void _communicationReplyWithException(
 // -----------------------------------------------------------------------------
 
 void _communicationWriteMultipleRegisters(
-    const word registerStartAddress,
-    const word writeLength,
     uint8_t * payload,
+    const uint16_t length,
+    const word registerAddress,
+    const word writeLength,
     const uint8_t registerType
 ) {
-/*
-    memset(_communication_output_buffer, 0, PJON_PACKET_MAX_LENGTH);
-
-    word register_address = (word) payload[1] << 8 | (word) payload[2];
-    word write_length = (word) payload[3] << 8 | (word) payload[4];
-    uint8_t bytes_count = (uint8_t) payload[5];
-
     #if DEBUG_COMMUNICATION_SUPPORT
-        DPRINT(F("[COMMUNICATION] Requested write to AO register at address: "));
-        DPRINT(register_address);
-        DPRINT(F(" and length: "));
-        DPRINTLN(write_length);
+        DLOG(LOG_COMMUNICATION_WRITE_MULTIPLE, registerType, registerAddress, writeLength);
     #endif
 
     if (
-        // Write start address mus be between <0, buffer.size()>
-        register_address < REGISTER_MAX_OUTPUT_REGISTERS_SIZE
-        // Write end address have to be same or smaller as register size
-        && (register_address + write_length) <= REGISTER_MAX_OUTPUT_REGISTERS_SIZE
+        writeLength == 0
+        // Write end address have to be same or smaller as registers size
+        || ((uint32_t) registerAddress + writeLength) > registerGetRegistersSize(registerType)
     ) {
-        uint8_t write_byte = 1;
-        uint8_t data_byte;
+        #if DEBUG_COMMUNICATION_SUPPORT
+            DLOG(LOG_COMMUNICATION_WRITE_MULTIPLE_OUT_OF_RANGE);
+        #endif
 
-        uint8_t write_address = register_address;
+        _communicationReplyWithException(payload, COMMUNICATION_EXCEPTION_OUT_OF_RANGE);
 
-        while (
-            write_address < (register_address + write_length)
-            && write_address < REGISTER_MAX_OUTPUT_REGISTERS_SIZE
-            && write_byte <= bytes_count
-        ) {
-            // TODO: Finish implementation
-        }
+        return;
+    }
 
-        // 0 => Packet identifier
-        // 1 => High byte of register address
-        // 2 => Low byte of register address
-        // 3 => High byte of write byte length
-        // 4 => Low byte of write byte length
-        _communication_output_buffer[0] = (char) packetId;
-        _communication_output_buffer[1] = (char) (register_address >> 8);
-        _communication_output_buffer[2] = (char) (register_address & 0xFF);
-        _communication_output_buffer[3] = (char) (write_byte >> 8);
-        _communication_output_buffer[4] = (char) (write_byte & 0xFF);
+    // Values are packed one after another, each in its data type size
+    uint16_t byte_pointer = 6;
 
-        #if DEBUG_COMMUNICATION_SUPPORT
-            // Reply to master
-            if (_communicationReplyToPacket(_communication_output_buffer, 5) == false) {
-                // Device was not able to notify master about its address
-                DPRINTLN(F("[COMMUNICATION][ERR] Master could not receive multiple AO register write result"));
+    // Whole request is validated first, so registers are not left partially written
+    for (word i = registerAddress; i < (registerAddress + writeLength); i++) {
+        #if REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
+            // Check if attribute register is writable
+            if (
+                registerType == REGISTER_TYPE_ATTRIBUTE
+                && registerIsAttributeSettable(i) == false
+            ) {
+                #if DEBUG_COMMUNICATION_SUPPORT
+                    DLOG(LOG_COMMUNICATION_NOT_WRITABLE, i);
+                #endif
 
-            } else {
-                DPRINTLN(F("[COMMUNICATION] Replied to master with multiple AO register write result"));
+                _communicationReplyWithException(payload, COMMUNICATION_EXCEPTION_NOT_WRITABLE);
+
+                return;
             }
-        #else
-            // Reply to master
-            _communicationReplyToPacket(_communication_output_buffer, 5);
         #endif
 
-    } else {
-        #if DEBUG_COMMUNICATION_SUPPORT
-            DPRINTLN(F("[COMMUNICATION][ERR] Master is trying to write to undefined AO registers range"));
-        #endif
+        uint8_t data_type_size = registerGetDataTypeSize(registerGetRegisterDataType(registerType, i));
+
+        if (data_type_size == 0 || (byte_pointer + data_type_size) > length) {
+            #if DEBUG_COMMUNICATION_SUPPORT
+                DLOG(LOG_COMMUNICATION_WRITE_MULTIPLE_TYPES_MISMATCH);
+            #endif
 
-        // TODO: Send exception
+            _communicationReplyWithException(payload, COMMUNICATION_EXCEPTION_BAD_LENGTH);
+
+            return;
+        }
+
+        if (
+            registerType == REGISTER_TYPE_ATTRIBUTE
+            && _communicationIsAttributeValueAccepted(i, &payload[byte_pointer]) == false
+        ) {
+            #if DEBUG_COMMUNICATION_SUPPORT
+                DLOG(LOG_COMMUNICATION_VALUE_REJECTED, i);
+            #endif
+
+            _communicationReplyWithException(payload, COMMUNICATION_EXCEPTION_OUT_OF_RANGE);
+
+            return;
+        }
+
+        byte_pointer = byte_pointer + data_type_size;
     }
-*/
+
+    byte_pointer = 6;
+
+    word write_counter = 0;
+
+    for (word i = registerAddress; i < (registerAddress + writeLength); i++) {
+        uint8_t data_type_size = registerGetDataTypeSize(registerGetRegisterDataType(registerType, i));
+
+        uint8_t write_value[4] = { 0, 0, 0, 0 };
+
+        memcpy(write_value, &payload[byte_pointer], data_type_size);
+
+        byte_pointer = byte_pointer + data_type_size;
+
+        if (registerWriteRegister(registerType, i, write_value, false) == false) {
+            #if DEBUG_COMMUNICATION_SUPPORT
+                DLOG(LOG_COMMUNICATION_WRITE_FAILED, i);
+            #endif
+
+            break;
+        }
+
+        write_counter++;
+    }
+
+    // 0    => Packet identifier
+    // 1    => Register type
+    // 2    => High byte of register address
+    // 3    => Low byte of register address
+    // 4    => High byte of written registers count
+    // 5    => Low byte of written registers count
+    _communication_output_buffer[0] = (char) COMMUNICATION_PACKET_WRITE_MULTIPLE_REGISTERS_VALUES;
+    _communication_output_buffer[1] = (char) registerType;
+    _communication_output_buffer[2] = (char) (registerAddress >> 8);
+    _communication_output_buffer[3] = (char) (registerAddress & 0xFF);
+    _communication_output_buffer[4] = (char) (write_counter >> 8);
+    _communication_output_buffer[5] = (char) (write_counter & 0xFF);
+
+    #if DEBUG_COMMUNICATION_SUPPORT
+        // Reply to master
+        if (_communicationReplyToPacket(_communication_output_buffer, 6) == false) {
+            DLOG(LOG_COMMUNICATION_WRITE_MULTIPLE_NOT_RECEIVED);
+
+        } else {
+            DLOG(LOG_COMMUNICATION_WRITE_MULTIPLE_REPLIED);
+        }
+    #else
+        // Reply to master
+        _communicationReplyToPacket(_communication_output_buffer, 6);
+    #endif
 }
 
 // -----------------------------------------------------------------------------
@@ -149,10 +476,12 @@ void _communicationWriteMultipleRegisters(
  * 3    => Low byte of register address
  * 4    => High byte of registers length
  * 5    => Low byte of registers length
- * 6-n  => Data to write into registers
+ * 6-n  => Data to write into registers, each value packed in its register data type size
  */
 void _communicationWriteMultipleRegistersValuesHandler(
-    uint8_t * payload
+    uint8_t * payload,
+    const uint16_t length,
+    const bool isBroadcast
 ) {
     uint8_t register_type = (uint8_t) payload[1];
 
@@ -167,22 +496,22 @@ void _communicationWriteMultipleRegistersValuesHandler(
 
         #if REGISTER_MAX_OUTPUT_REGISTERS_SIZE
             case REGISTER_TYPE_OUTPUT:
-                _communicationWriteMultipleRegisters(register_start_address, write_length, payload, REGISTER_TYPE_OUTPUT);
+                _communicationWriteMultipleRegisters(payload, length, register_start_address, write_length, REGISTER_TYPE_OUTPUT);
                 break;
         #endif
 
         #if REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
             case REGISTER_TYPE_ATTRIBUTE:
-                _communicationWriteMultipleRegisters(register_start_address, write_length, payload, REGISTER_TYPE_ATTRIBUTE);
+                _communicationWriteMultipleRegisters(payload, length, register_start_address, write_length, REGISTER_TYPE_ATTRIBUTE);
                 break;
         #endif
 
         default:
             #if DEBUG_COMMUNICATION_SUPPORT
-                DPRINTLN(F("[COMMUNICATION][ERR] Master is trying to write to undefined registers type"));
+                DLOG(LOG_COMMUNICATION_UNDEFINED_TYPE, register_type);
             #endif
 
-            _communicationReplyWithException(payload);
+            _communicationReplyWithException(payload, COMMUNICATION_EXCEPTION_OUT_OF_RANGE);
 
     }
 }
@@ -191,58 +520,63 @@ void _communicationWriteMultipleRegistersValuesHandler(
 // WRITING SINGLE REGISTER
 // -----------------------------------------------------------------------------
 
-bool _communicationWriteSingleRegisterValue(
+uint8_t _communicationWriteSingleRegisterValue(
     uint8_t * writeValue,
     const word registerAddress,
     const uint8_t registerType
 ) {
     #if DEBUG_COMMUNICATION_SUPPORT
-        DPRINT(F("[COMMUNICATION] Requested writing value to single"));
-        if (registerType == REGISTER_TYPE_OUTPUT) {
-            DPRINT(F(" output "));
-        } else if (registerType == REGISTER_TYPE_ATTRIBUTE) {
-            DPRINT(F(" attribute "));
-        }
-        DPRINT(F("register at address: "));
-        DPRINTLN(registerAddress);
+        DLOG(LOG_COMMUNICATION_WRITE_SINGLE, registerType, registerAddress);
     #endif
 
+    // Register module is addressed by one byte, address have to be validated before it is narrowed
+    if (registerAddress >= registerGetRegistersSize(registerType)) {
+        #if DEBUG_COMMUNICATION_SUPPORT
+            DLOG(LOG_COMMUNICATION_WRITE_SINGLE_OUT_OF_RANGE, registerAddress);
+        #endif
+
+        return COMMUNICATION_EXCEPTION_OUT_OF_RANGE;
+    }
+
     #if REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
         // Special handling for extra registers
         if (registerType == REGISTER_TYPE_ATTRIBUTE) {
-            if (
-                registerAddress >= REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
-                || register_module_attribute_registers[registerAddress].settable == false
-            ) {
+            if (registerIsAttributeSettable(registerAddress) == false) {
+                #if DEBUG_COMMUNICATION_SUPPORT
+                    DLOG(LOG_COMMUNICATION_NOT_WRITABLE, registerAddress);
+                #endif
+
+                return COMMUNICATION_EXCEPTION_NOT_WRITABLE;
+            }
+
+            if (_communicationIsAttributeValueAccepted(registerAddress, writeValue) == false) {
                 #if DEBUG_COMMUNICATION_SUPPORT
-                    DPRINTLN(F("[COMMUNICATION][ERR] Attribute register is not writtable or out of range"));
+                    DLOG(LOG_COMMUNICATION_VALUE_REJECTED, registerAddress);
                 #endif
 
-                return false;
+                return COMMUNICATION_EXCEPTION_OUT_OF_RANGE;
             }
         }
     #endif
 
     if (registerWriteRegister(registerType, registerAddress, writeValue, false) == false) {
         #if DEBUG_COMMUNICATION_SUPPORT
-            DPRINTLN(F("[COMMUNICATION][ERR] Value could not be written into register"));
+            DLOG(LOG_COMMUNICATION_WRITE_FAILED, registerAddress);
         #endif
 
-        return false;
+        return COMMUNICATION_EXCEPTION_OUT_OF_RANGE;
     }
 
     uint8_t stored_value[4] = { 0, 0, 0, 0 };
 
     if (registerReadRegister(registerType, registerAddress, stored_value) == false) {
         #if DEBUG_COMMUNICATION_SUPPORT
-            DPRINTLN(F("[COMMUNICATION][ERR] Written value could not be fetched from register"));
+            DLOG(LOG_COMMUNICATION_WRITE_SINGLE_NOT_FETCHED);
         #endif
 
-        return false;
+        return COMMUNICATION_EXCEPTION_OUT_OF_RANGE;
     }
 
-    memset(_communication_output_buffer, 0, PJON_PACKET_MAX_LENGTH);
-
     // 0    => Packet identifier
     // 1    => Register type
     // 2    => High byte of register address
@@ -261,16 +595,16 @@ bool _communicationWriteSingleRegisterValue(
         // Reply to master
         if (_communicationReplyToPacket(_communication_output_buffer, 8) == false) {
             // Device was not able to notify master about its address
-            DPRINTLN(F("[COMMUNICATION][ERR] Master could not receive register write result"));
+            DLOG(LOG_COMMUNICATION_WRITE_SINGLE_NOT_RECEIVED);
 
         } else {
-            DPRINTLN(F("[COMMUNICATION] Replied to master with register write result"));
+            DLOG(LOG_COMMUNICATION_WRITE_SINGLE_REPLIED);
         }
     #else
         _communicationReplyToPacket(_communication_output_buffer, 8);
     #endif
 
-    return true;
+    return COMMUNICATION_EXCEPTION_NONE;
 }
 
 // -----------------------------------------------------------------------------
@@ -285,14 +619,22 @@ bool _communicationWriteSingleRegisterValue(
  * 4-5(7)   => Data to write into register
  */
 void _communicationWriteSingleRegisterValueHandler(
-    uint8_t * payload
+    uint8_t * payload,
+    const uint16_t length,
+    const bool isBroadcast
 ) {
+    if (isBroadcast) {
+        _communicationWriteSingleAttributeRegisterValueFromBroadcastHandler(payload, length);
+
+        return;
+    }
+
     uint8_t register_type = (uint8_t) payload[1];
 
     // Register write address
     word register_address = (word) payload[2] << 8 | (word) payload[3];
 
-    bool result = false;
+    uint8_t exception = COMMUNICATION_EXCEPTION_OUT_OF_RANGE;
 
     switch (register_type)
     {
@@ -307,7 +649,7 @@ void _communicationWriteSingleRegisterValueHandler(
                 write_value[2] = payload[6];
                 write_value[3] = payload[7];
 
-                result = _communicationWriteSingleRegisterValue(write_value, register_address, REGISTER_TYPE_OUTPUT);
+                exception = _communicationWriteSingleRegisterValue(write_value, register_address, REGISTER_TYPE_OUTPUT);
                 break;
             }
         #endif
@@ -322,22 +664,22 @@ void _communicationWriteSingleRegisterValueHandler(
                 write_value[2] = payload[6];
                 write_value[3] = payload[7];
 
-                result = _communicationWriteSingleRegisterValue(write_value, register_address, REGISTER_TYPE_ATTRIBUTE);
+                exception = _communicationWriteSingleRegisterValue(write_value, register_address, REGISTER_TYPE_ATTRIBUTE);
                 break;
             }
         #endif
 
         default:
             #if DEBUG_COMMUNICATION_SUPPORT
-                DPRINTLN(F("[COMMUNICATION][ERR] Master is trying to write to undefined registers type"));
+                DLOG(LOG_COMMUNICATION_UNDEFINED_TYPE, register_type);
             #endif
 
-            _communicationReplyWithException(payload);
+            break;
 
     }
 
-    if (result == false) {
-        _communicationReplyWithException(payload);
+    if (exception != COMMUNICATION_EXCEPTION_NONE) {
+        _communicationReplyWithException(payload, exception);
     }
 }
 
@@ -355,38 +697,15 @@ void _communicationWriteSingleRegisterValueHandler(
  * n+4-7    => Data to write into register
  */
 void _communicationWriteSingleAttributeRegisterValueFromBroadcastHandler(
-    uint8_t * payload
+    uint8_t * payload,
+    const uint16_t length
 ) {
-    // Extract device SN length
-    uint8_t device_sn_length = (uint8_t) payload[1];
-
-    // Initialize serial number buffer
-    char device_sn[device_sn_length];
-
-    memset(device_sn, 0, device_sn_length);
-
-    // Extract serial number from payload
-    for (uint8_t i = 0; i < device_sn_length; i++) {
-        device_sn[i] = (char) payload[i + 2];
-        device_sn[i + 1] = 0x00; // Add a NULL after each character
-    }
-
-    // Check if received packet is for this device
-    if (strcmp(DEVICE_SERIAL_NO, device_sn) != 0) {
-        #if DEBUG_COMMUNICATION_SUPPORT
-            DPRINT(F("[COMMUNICATION][INFO] Packet is for other device: \""));
-            DPRINT(device_sn);
-            DPRINTLN(F("\""));
-            DPRINT(F("[COMMUNICATION][INFO] Device SN is: \""));
-            DPRINT((char *) DEVICE_SERIAL_NO);
-            DPRINTLN(F("\""));
-        #endif
+    uint8_t data_start_position = 0;
 
+    if (_communicationIsAddressedBySerialNumber(payload, length, 8, data_start_position) == false) {
         return;
     }
 
-    uint8_t data_start_position = device_sn_length + 1;
-
     uint8_t register_type = (uint8_t) payload[data_start_position + 1];
 
     // Register write address
@@ -399,22 +718,22 @@ void _communicationWriteSingleAttributeRegisterValueFromBroadcastHandler(
     write_value[2] = payload[data_start_position + 6];
     write_value[3] = payload[data_start_position + 7];
 
-    bool result = false;
+    uint8_t exception = COMMUNICATION_EXCEPTION_OUT_OF_RANGE;
 
     switch (register_type)
     {
         #if REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
             case REGISTER_TYPE_ATTRIBUTE:
             {
-                result = _communicationWriteSingleRegisterValue(write_value, register_address, REGISTER_TYPE_ATTRIBUTE);
+                exception = _communicationWriteSingleRegisterValue(write_value, register_address, REGISTER_TYPE_ATTRIBUTE);
                 break;
             }
         #endif
 
     }
 
-    if (result == false) {
-        _communicationReplyWithException(payload);
+    if (exception != COMMUNICATION_EXCEPTION_NONE) {
+        _communicationReplyWithException(payload, exception);
     }
 }
 #endif
@@ -428,99 +747,105 @@ void _communicationWriteSingleAttributeRegisterValueFromBroadcastHandler(
 void _communicationReadMultipleRegistersValues(
     uint8_t * payload,
     const word registerAddress,
-    const uint8_t readLength,
+    const word readLength,
     const uint8_t registerType
 ) {
     #if DEBUG_COMMUNICATION_SUPPORT
-        DPRINT(F("[COMMUNICATION] Requested reading values from multiple"));
-        if (registerType == REGISTER_TYPE_INPUT) {
-            DPRINT(F(" inputs "));
-        } else if (registerType == REGISTER_TYPE_OUTPUT) {
-            DPRINT(F(" outputs "));
-        } else if (registerType == REGISTER_TYPE_ATTRIBUTE) {
-            DPRINT(F(" attributes "));
-        }
-        DPRINT(F("registers from address: "));
-        DPRINT(registerAddress);
-        DPRINT(F(" and length: "));
-        DPRINTLN(readLength);
+        DLOG(LOG_COMMUNICATION_READ_MULTIPLE, registerType, registerAddress, readLength);
     #endif
 
-    memset(_communication_output_buffer, 0, PJON_PACKET_MAX_LENGTH);
+    if (
+        readLength == 0
+        // Read end address have to be same or smaller as registers size
+        || ((uint32_t) registerAddress + readLength) > registerGetRegistersSize(registerType)
+    ) {
+        #if DEBUG_COMMUNICATION_SUPPORT
+            DLOG(LOG_COMMUNICATION_READ_MULTIPLE_OUT_OF_RANGE);
+        #endif
+
+        _communicationReplyWithException(payload, COMMUNICATION_EXCEPTION_OUT_OF_RANGE);
+
+        return;
+    }
 
     // 0    => Packet identifier
-    // 1    => High byte of register address
-    // 2    => Low byte of register address
-    // 3    => Count of registers
-    // 4-n  => Packet data
+    // 1    => Register type
+    // 2    => High byte of register address
+    // 3    => Low byte of register address
+    // 4    => Count of registers in reply
+    // 5    => High byte of address to continue reading from
+    // 6    => Low byte of address to continue reading from
+    // 7-n  => Registers values, each in its data type size
     _communication_output_buffer[0] = (char) COMMUNICATION_PACKET_READ_MULTIPLE_REGISTERS_VALUES;
     _communication_output_buffer[1] = (char) registerType;
     _communication_output_buffer[2] = (char) (registerAddress >> 8);
     _communication_output_buffer[3] = (char) (registerAddress & 0xFF);
-    _communication_output_buffer[4] = (char) 0; // Temporary value, will be updated after collecting all
 
-    uint8_t byte_counter = 5;
-    uint8_t byte_pointer = 5;
+    uint8_t byte_pointer = 7;
     uint8_t registers_counter = 0;
 
+    word continue_address = COMMUNICATION_REGISTER_ADDRESS_NONE;
+
     uint8_t read_value[4] = { 0, 0, 0, 0 };
 
-    for (uint8_t i = registerAddress; i < (registerAddress + readLength); i++) {
+    for (word i = registerAddress; i < (registerAddress + readLength); i++) {
         #if REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
             // Check if attribute register is queryable
             if (
                 registerType == REGISTER_TYPE_ATTRIBUTE
-                && (
-                    i >= REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
-                    || register_module_attribute_registers[i].queryable == false
-                )
+                && registerIsAttributeQueryable(i) == false
             ) {
                 #if DEBUG_COMMUNICATION_SUPPORT
-                    DPRINTLN(F("[COMMUNICATION][ERR] Attribute register is not readable or out of range"));
+                    DLOG(LOG_COMMUNICATION_NOT_READABLE, i);
                 #endif
 
-                _communicationReplyWithException(payload);
+                _communicationReplyWithException(payload, COMMUNICATION_EXCEPTION_NOT_READABLE);
 
                 return;
             }
         #endif
 
-        if (registerReadRegister(registerType, i, read_value) == false) {
+        uint8_t data_type_size = registerGetDataTypeSize(registerGetRegisterDataType(registerType, i));
+
+        if (data_type_size == 0 || registerReadRegister(registerType, i, read_value) == false) {
             #if DEBUG_COMMUNICATION_SUPPORT
-                DPRINTLN(F("[COMMUNICATION][ERR] Value could not be fetched from register"));
+                DLOG(LOG_COMMUNICATION_READ_FAILED, i);
             #endif
 
+            _communicationReplyWithException(payload, COMMUNICATION_EXCEPTION_NOT_READABLE);
+
             return;
         }
 
-        _communication_output_buffer[byte_pointer] = (char) read_value[0];
-        byte_pointer++;
-        _communication_output_buffer[byte_pointer] = (char) read_value[1];
-        byte_pointer++;
-        _communication_output_buffer[byte_pointer] = (char) read_value[2];
-        byte_pointer++;
-        _communication_output_buffer[byte_pointer] = (char) read_value[3];
-        byte_pointer++;
+        // Rest of registers have to be requested by master in next packet
+        if ((byte_pointer + data_type_size) > (PJON_PACKET_MAX_LENGTH - COMMUNICATION_PACKET_OVERHEAD)) {
+            continue_address = i;
+
+            break;
+        }
+
+        memcpy(&_communication_output_buffer[byte_pointer], read_value, data_type_size);
 
-        byte_counter = byte_counter + 4;
+        byte_pointer = byte_pointer + data_type_size;
 
         registers_counter++;
     }
 
-    // Update registers length
     _communication_output_buffer[4] = (char) registers_counter;
+    _communication_output_buffer[5] = (char) (continue_address >> 8);
+    _communication_output_buffer[6] = (char) (continue_address & 0xFF);
 
     #if DEBUG_COMMUNICATION_SUPPORT
         // Reply to master
-        if (_communicationReplyToPacket(_communication_output_buffer, byte_counter) == false) {
-            DPRINTLN(F("[COMMUNICATION][ERR] Master could not receive multiple registers reading"));
+        if (_communicationReplyToPacket(_communication_output_buffer, byte_pointer) == false) {
+            DLOG(LOG_COMMUNICATION_READ_MULTIPLE_NOT_RECEIVED);
 
         } else {
-            DPRINTLN(F("[COMMUNICATION] Replied to master with multiple registers content"));
+            DLOG(LOG_COMMUNICATION_READ_MULTIPLE_REPLIED);
         }
     #else
         // Reply to master
-        _communicationReplyToPacket(_communication_output_buffer, byte_counter);
+        _communicationReplyToPacket(_communication_output_buffer, byte_pointer);
     #endif
 }
 
@@ -537,7 +862,9 @@ void _communicationReadMultipleRegistersValues(
  * 5 => Low byte of registers length
  */
 void _communicationReadMultipleRegistersValuesHandler(
-    uint8_t * payload
+    uint8_t * payload,
+    const uint16_t length,
+    const bool isBroadcast
 ) {
     uint8_t register_type = (uint8_t) payload[1];
 
@@ -570,10 +897,10 @@ void _communicationReadMultipleRegistersValuesHandler(
 
         default:
             #if DEBUG_COMMUNICATION_SUPPORT
-                DPRINTLN(F("[COMMUNICATION][ERR] Master is trying to read from undefined registers type"));
+                DLOG(LOG_COMMUNICATION_UNDEFINED_TYPE, register_type);
             #endif
 
-            _communicationReplyWithException(payload);
+            _communicationReplyWithException(payload, COMMUNICATION_EXCEPTION_OUT_OF_RANGE);
 
     }
 }
@@ -588,32 +915,31 @@ void _communicationReadSingleRegisterValue(
     const uint8_t registerType
 ) {    
     #if DEBUG_COMMUNICATION_SUPPORT
-        DPRINT(F("[COMMUNICATION] Requested reading value from single"));
-        if (registerType == REGISTER_TYPE_INPUT) {
-            DPRINT(F(" input "));
-        } else if (registerType == REGISTER_TYPE_OUTPUT) {
-            DPRINT(F(" output "));
-        } else if (registerType == REGISTER_TYPE_ATTRIBUTE) {
-            DPRINT(F(" attribute "));
-        }
-        DPRINT(F("register at address: "));
-        DPRINTLN(registerAddress);
+        DLOG(LOG_COMMUNICATION_READ_SINGLE, registerType, registerAddress);
     #endif
 
+    // Register module is addressed by one byte, address have to be validated before it is narrowed
+    if (registerAddress >= registerGetRegistersSize(registerType)) {
+        #if DEBUG_COMMUNICATION_SUPPORT
+            DLOG(LOG_COMMUNICATION_READ_SINGLE_OUT_OF_RANGE, registerAddress);
+        #endif
+
+        _communicationReplyWithException(payload, COMMUNICATION_EXCEPTION_OUT_OF_RANGE);
+
+        return;
+    }
+
     #if REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
         // Check if attribute register is queryable
         if (
             registerType == REGISTER_TYPE_ATTRIBUTE
-            && (
-                registerAddress >= REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
-                || register_module_attribute_registers[registerAddress].queryable == false
-            )
+            && registerIsAttributeQueryable(registerAddress) == false
         ) {
             #if DEBUG_COMMUNICATION_SUPPORT
-                DPRINTLN(F("[COMMUNICATION][ERR] Attribute register is not readable or out of range"));
+                DLOG(LOG_COMMUNICATION_NOT_READABLE, registerAddress);
             #endif
 
-            _communicationReplyWithException(payload);
+            _communicationReplyWithException(payload, COMMUNICATION_EXCEPTION_NOT_READABLE);
 
             return;
         }
@@ -623,16 +949,14 @@ void _communicationReadSingleRegisterValue(
 
     if (registerReadRegister(registerType, registerAddress, read_value) == false) {
         #if DEBUG_COMMUNICATION_SUPPORT
-            DPRINTLN(F("[COMMUNICATION][ERR] Value could not be fetched from register"));
+            DLOG(LOG_COMMUNICATION_READ_FAILED, registerAddress);
         #endif
 
-        _communicationReplyWithException(payload);
+        _communicationReplyWithException(payload, COMMUNICATION_EXCEPTION_OUT_OF_RANGE);
 
         return;
     }
 
-    memset(_communication_output_buffer, 0, PJON_PACKET_MAX_LENGTH);
-
     // 0    => Packet identifier
     // 1    => Register type
     // 2    => High byte of register address
@@ -650,10 +974,10 @@ void _communicationReadSingleRegisterValue(
     #if DEBUG_COMMUNICATION_SUPPORT
         // Reply to master
         if (_communicationReplyToPacket(_communication_output_buffer, 8) == false) {
-            DPRINTLN(F("[COMMUNICATION][ERR] Master could not receive register reading"));
+            DLOG(LOG_COMMUNICATION_READ_SINGLE_NOT_RECEIVED);
 
         } else {
-            DPRINTLN(F("[COMMUNICATION] Replied to master with one register content"));
+            DLOG(LOG_COMMUNICATION_READ_SINGLE_REPLIED);
         }
     #else
         // Reply to master
@@ -672,7 +996,9 @@ void _communicationReadSingleRegisterValue(
  * 3 => Low byte of register address
  */
 void _communicationReadSingleRegisterValueHandler(
-    uint8_t * payload
+    uint8_t * payload,
+    const uint16_t length,
+    const bool isBroadcast
 ) {
     uint8_t register_type = (uint8_t) payload[1];
 
@@ -702,66 +1028,34 @@ void _communicationReadSingleRegisterValueHandler(
 
         default:
             #if DEBUG_COMMUNICATION_SUPPORT
-                DPRINTLN(F("[COMMUNICATION][ERR] Master is trying to read from undefined register type"));
+                DLOG(LOG_COMMUNICATION_UNDEFINED_TYPE, register_type);
             #endif
 
-            _communicationReplyWithException(payload);
+            _communicationReplyWithException(payload, COMMUNICATION_EXCEPTION_OUT_OF_RANGE);
 
     }
 }
 
 #endif
 
-// -----------------------------------------------------------------------------
-
 #if REGISTER_MAX_INPUT_REGISTERS_SIZE || REGISTER_MAX_OUTPUT_REGISTERS_SIZE || REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
 
+// -----------------------------------------------------------------------------
+// READING SINGLE REGISTER STRUCTURE
+// -----------------------------------------------------------------------------
+
 bool _communicationReadSingleRegisterStructure(
     const word registerAddress,
     const uint8_t registerType
 ) {
     #if DEBUG_COMMUNICATION_SUPPORT
-        DPRINT(F("[COMMUNICATION] Requested reading structure from single"));
-        if (registerType == REGISTER_TYPE_INPUT) {
-            DPRINT(F(" input "));
-        } else if (registerType == REGISTER_TYPE_OUTPUT) {
-            DPRINT(F(" output "));
-        } else if (registerType == REGISTER_TYPE_ATTRIBUTE) {
-            DPRINT(F(" attribute "));
-        }
-        DPRINT(F("register at address: "));
-        DPRINTLN(registerAddress);
-    #endif
-
-    uint8_t registers_size = 0;
-
-    #if REGISTER_MAX_INPUT_REGISTERS_SIZE
-        // Get total registers count
-        if (registerType == REGISTER_TYPE_INPUT) {
-            registers_size = REGISTER_MAX_INPUT_REGISTERS_SIZE;
-        }
-    #endif
-
-    #if REGISTER_MAX_OUTPUT_REGISTERS_SIZE
-        // Get total registers count
-        if (registerType == REGISTER_TYPE_OUTPUT) {
-            registers_size = REGISTER_MAX_OUTPUT_REGISTERS_SIZE;
-        }
-    #endif
-
-    #if REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
-        // Get total registers count
-        if (registerType == REGISTER_TYPE_ATTRIBUTE) {
-            registers_size = REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE;
-        }
+        DLOG(LOG_COMMUNICATION_STRUCTURE_SINGLE, registerType, registerAddress);
     #endif
 
     if (
         // Read start address mus be between <0, registers_size>
-        registerAddress < registers_size
+        registerAddress < registerGetRegistersSize(registerType)
     ) {
-        memset(_communication_output_buffer, 0, PJON_PACKET_MAX_LENGTH);
-
         // 0 => Packet identifier
         // 1 => Registers type
         // 2 => High byte of register address
@@ -773,7 +1067,6 @@ bool _communicationReadSingleRegisterStructure(
         _communication_output_buffer[3] = (char) (registerAddress & 0xFF);
         _communication_output_buffer[4] = (char) registerGetRegisterDataType(registerType, registerAddress);
 
-        uint8_t byte_pointer = 5;
         uint8_t byte_counter = 5;
 
         if (registerType == REGISTER_TYPE_ATTRIBUTE) {
@@ -783,30 +1076,28 @@ bool _communicationReadSingleRegisterStructure(
             // 8    => Low byte of register queryable flag
             // 9    => Register name length
             // 10-n => Register name
-            _communication_output_buffer[5] = (char) (register_module_attribute_registers[registerAddress].settable ? (REGISTER_BOOLEAN_VALUE_TRUE >> 8) : (REGISTER_BOOLEAN_VALUE_FALSE >> 8));
-            _communication_output_buffer[6] = (char) (register_module_attribute_registers[registerAddress].settable ? (REGISTER_BOOLEAN_VALUE_TRUE & 0xFF) : (REGISTER_BOOLEAN_VALUE_FALSE & 0xFF));
-            _communication_output_buffer[7] = (char) (register_module_attribute_registers[registerAddress].queryable ? (REGISTER_BOOLEAN_VALUE_TRUE >> 8) : (REGISTER_BOOLEAN_VALUE_FALSE >> 8));
-            _communication_output_buffer[8] = (char) (register_module_attribute_registers[registerAddress].queryable ? (REGISTER_BOOLEAN_VALUE_TRUE & 0xFF) : (REGISTER_BOOLEAN_VALUE_FALSE & 0xFF));
-            _communication_output_buffer[9] = (char) strlen(register_module_attribute_registers[registerAddress].name);
+            bool settable = registerIsAttributeSettable(registerAddress);
+            bool queryable = registerIsAttributeQueryable(registerAddress);
 
-            byte_pointer = 10;
-            byte_counter = 10;
+            _communication_output_buffer[5] = (char) (settable ? (REGISTER_BOOLEAN_VALUE_TRUE >> 8) : (REGISTER_BOOLEAN_VALUE_FALSE >> 8));
+            _communication_output_buffer[6] = (char) (settable ? (REGISTER_BOOLEAN_VALUE_TRUE & 0xFF) : (REGISTER_BOOLEAN_VALUE_FALSE & 0xFF));
+            _communication_output_buffer[7] = (char) (queryable ? (REGISTER_BOOLEAN_VALUE_TRUE >> 8) : (REGISTER_BOOLEAN_VALUE_FALSE >> 8));
+            _communication_output_buffer[8] = (char) (queryable ? (REGISTER_BOOLEAN_VALUE_TRUE & 0xFF) : (REGISTER_BOOLEAN_VALUE_FALSE & 0xFF));
 
-            for (uint8_t char_pos = 0; char_pos < strlen(register_module_attribute_registers[registerAddress].name); char_pos++) {
-                _communication_output_buffer[byte_pointer] = (char) register_module_attribute_registers[registerAddress].name[char_pos];
+            uint8_t name_length = registerReadAttributeName(registerAddress, &_communication_output_buffer[10]);
 
-                byte_pointer++;
-                byte_counter++;
-            }
+            _communication_output_buffer[9] = (char) name_length;
+
+            byte_counter = 10 + name_length;
         }
 
         #if DEBUG_COMMUNICATION_SUPPORT
             // Reply to master
             if (_communicationReplyToPacket(_communication_output_buffer, byte_counter) == false) {
-                DPRINTLN(F("[COMMUNICATION][ERR] Master could not receive device register structure"));
+                DLOG(LOG_COMMUNICATION_STRUCTURE_SINGLE_NOT_RECEIVED);
 
             } else {
-                DPRINTLN(F("[COMMUNICATION] Replied to master with register structure"));
+                DLOG(LOG_COMMUNICATION_STRUCTURE_SINGLE_REPLIED);
             }
         #else
             // Reply to master
@@ -817,7 +1108,7 @@ bool _communicationReadSingleRegisterStructure(
 
     } else {
         #if DEBUG_COMMUNICATION_SUPPORT
-            DPRINTLN(F("[COMMUNICATION][ERR] Master is trying to read structure for undefined registers range"));
+            DLOG(LOG_COMMUNICATION_STRUCTURE_OUT_OF_RANGE);
         #endif
 
         return false;
@@ -847,99 +1138,248 @@ bool _communicationReadSingleRegisterStructure(
 void _communicationReadSingleRegisterStructureHandler(
     uint8_t * payload,
     const uint16_t length,
-    const bool isBroadcasted
+    const bool isBroadcast
 ) {
-    uint8_t data_payload[length];
+    // Position of register type is shifted by device SN when broadcasted
+    uint8_t byte_offset = 0;
 
-    memset(data_payload, 0, length);
+    if (isBroadcast && _communicationIsAddressedBySerialNumber(payload, length, 4, byte_offset) == false) {
+        return;
+    }
 
-    uint8_t byte_position = 0;
+    uint8_t register_type = (uint8_t) payload[byte_offset + 1];
 
-    if (isBroadcasted) {
-        // Extract device SN length
-        uint8_t device_sn_length = (uint8_t) payload[1];
+    // Register read address
+    word register_address = (word) payload[byte_offset + 2] << 8 | (word) payload[byte_offset + 3];
 
-        // Initialize serial number buffer
-        char device_sn[device_sn_length];
+    bool result = false;
 
-        memset(device_sn, 0, device_sn_length);
+    switch (register_type)
+    {
 
-        // Extract serial number from payload
-        for (uint8_t i = 0; i < device_sn_length; i++) {
-            device_sn[i] = (char) payload[i + 2];
-            device_sn[i + 1] = 0x00; // Add a NULL after each character
-        }
+        #if REGISTER_MAX_INPUT_REGISTERS_SIZE
+            case REGISTER_TYPE_INPUT:
+                result = _communicationReadSingleRegisterStructure(register_address, REGISTER_TYPE_INPUT);
+                break;
+        #endif
+
+        #if REGISTER_MAX_OUTPUT_REGISTERS_SIZE
+            case REGISTER_TYPE_OUTPUT:
+                result = _communicationReadSingleRegisterStructure(register_address, REGISTER_TYPE_OUTPUT);
+                break;
+        #endif
+
+        #if REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
+            case REGISTER_TYPE_ATTRIBUTE:
+                result = _communicationReadSingleRegisterStructure(register_address, REGISTER_TYPE_ATTRIBUTE);
+                break;
+        #endif
 
-        // Check if received packet is for this device
-        if (strcmp(DEVICE_SERIAL_NO, device_sn) != 0) {
+        default:
             #if DEBUG_COMMUNICATION_SUPPORT
-                DPRINT(F("[COMMUNICATION][INFO] Packet is for other device: \""));
-                DPRINT(device_sn);
-                DPRINTLN(F("\""));
-                DPRINT(F("[COMMUNICATION][INFO] Device SN is: \""));
-                DPRINT((char *) DEVICE_SERIAL_NO);
-                DPRINTLN(F("\""));
+                DLOG(LOG_COMMUNICATION_UNDEFINED_TYPE, register_type);
             #endif
 
-            return;
-        }
+            break;
+
+    }
+
+    if (result == false) {
+        _communicationReplyWithException(payload, COMMUNICATION_EXCEPTION_OUT_OF_RANGE);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// READING MULTIPLE REGISTERS STRUCTURE
+// -----------------------------------------------------------------------------
+
+void _communicationReadMultipleRegistersStructure(
+    uint8_t * payload,
+    const word registerAddress,
+    const word readLength,
+    const uint8_t registerType
+) {
+    #if DEBUG_COMMUNICATION_SUPPORT
+        DLOG(LOG_COMMUNICATION_STRUCTURE_MULTIPLE, registerType, registerAddress, readLength);
+    #endif
+
+    if (
+        readLength == 0
+        // Read end address have to be same or smaller as registers size
+        || ((uint32_t) registerAddress + readLength) > registerGetRegistersSize(registerType)
+    ) {
+        #if DEBUG_COMMUNICATION_SUPPORT
+            DLOG(LOG_COMMUNICATION_STRUCTURE_OUT_OF_RANGE);
+        #endif
 
-        // Append packet identifier
-        data_payload[0] = payload[0];
+        _communicationReplyWithException(payload, COMMUNICATION_EXCEPTION_OUT_OF_RANGE);
 
-        for (uint8_t i = (device_sn_length + 1); i < length; i++){
-            data_payload[byte_position] = payload[i];
+        return;
+    }
+
+    // 0    => Packet identifier
+    // 1    => Register type
+    // 2    => High byte of register address
+    // 3    => Low byte of register address
+    // 4    => Count of registers structures in reply
+    // 5    => High byte of address to continue reading from
+    // 6    => Low byte of address to continue reading from
+    // 7-n  => Registers structures
+    _communication_output_buffer[0] = (char) COMMUNICATION_PACKET_READ_MULTIPLE_REGISTER_STRUCTURE;
+    _communication_output_buffer[1] = (char) registerType;
+    _communication_output_buffer[2] = (char) (registerAddress >> 8);
+    _communication_output_buffer[3] = (char) (registerAddress & 0xFF);
+
+    uint8_t byte_pointer = 7;
+    uint8_t registers_counter = 0;
+
+    uint8_t free_space = (PJON_PACKET_MAX_LENGTH - COMMUNICATION_PACKET_OVERHEAD) - byte_pointer;
+
+    if (registerType == REGISTER_TYPE_ATTRIBUTE) {
+        // Each structure is composed from:
+        // 0    => Register data type
+        // 1    => Register flags                => COMMUNICATION_REGISTER_STRUCTURE_SETTABLE | COMMUNICATION_REGISTER_STRUCTURE_QUERYABLE
+        // 2    => Register name length
+        // 3-n  => Register name
+        char name[REGISTER_ATTRIBUTE_NAME_SIZE];
+
+        for (word i = registerAddress; i < (registerAddress + readLength); i++) {
+            uint8_t name_length = registerReadAttributeName(i, name);
+
+            // Rest of structures have to be requested by master in next packet
+            if ((byte_pointer + 3 + name_length) > (PJON_PACKET_MAX_LENGTH - COMMUNICATION_PACKET_OVERHEAD)) {
+                break;
+            }
+
+            _communication_output_buffer[byte_pointer] = (char) registerGetRegisterDataType(registerType, i);
+            _communication_output_buffer[byte_pointer + 1] = (char) (
+                (registerIsAttributeSettable(i) ? COMMUNICATION_REGISTER_STRUCTURE_SETTABLE : 0)
+                | (registerIsAttributeQueryable(i) ? COMMUNICATION_REGISTER_STRUCTURE_QUERYABLE : 0)
+            );
+            _communication_output_buffer[byte_pointer + 2] = (char) name_length;
+
+            memcpy(&_communication_output_buffer[byte_pointer + 3], name, name_length);
 
-            byte_position++;
+            byte_pointer = byte_pointer + 3 + name_length;
+
+            registers_counter++;
         }
 
     } else {
-        for (uint8_t i = 0; i < length; i++){
-            data_payload[byte_position] = payload[i];
+        // Inputs & outputs structures are composed only from data type, whole range is copied from flash at once
+        registers_counter = registerReadRegistersDataTypes(
+            registerType,
+            registerAddress,
+            readLength > free_space ? free_space : readLength,
+            (uint8_t *) &_communication_output_buffer[byte_pointer]
+        );
+
+        byte_pointer = byte_pointer + registers_counter;
+    }
+
+    // Master would be requesting same address again
+    if (registers_counter == 0) {
+        #if DEBUG_COMMUNICATION_SUPPORT
+            DLOG(LOG_COMMUNICATION_STRUCTURE_TOO_LONG);
+        #endif
+
+        _communicationReplyWithException(payload, COMMUNICATION_EXCEPTION_BAD_LENGTH);
+
+        return;
+    }
+
+    word continue_address = registers_counter < readLength ? (word) (registerAddress + registers_counter) : (word) COMMUNICATION_REGISTER_ADDRESS_NONE;
 
-            byte_position++;
+    _communication_output_buffer[4] = (char) registers_counter;
+    _communication_output_buffer[5] = (char) (continue_address >> 8);
+    _communication_output_buffer[6] = (char) (continue_address & 0xFF);
+
+    #if DEBUG_COMMUNICATION_SUPPORT
+        // Reply to master
+        if (_communicationReplyToPacket(_communication_output_buffer, byte_pointer) == false) {
+            DLOG(LOG_COMMUNICATION_STRUCTURE_MULTIPLE_NOT_RECEIVED);
+
+        } else {
+            DLOG(LOG_COMMUNICATION_STRUCTURE_MULTIPLE_REPLIED);
         }
+    #else
+        // Reply to master
+        _communicationReplyToPacket(_communication_output_buffer, byte_pointer);
+    #endif
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Parse received payload - Requesting reading multiple registers structure
+ *
+ * // When broadcasted
+ * 0    => Received packet identifier       => COMMUNICATION_PACKET_READ_MULTIPLE_REGISTER_STRUCTURE
+ * 1    => Device SN length
+ * 2-n  => Device SN                        => (a,b,c,...)
+ * n+1  => Register type
+ * n+2  => High byte of register address
+ * n+3  => Low byte of register address
+ * n+4  => High byte of registers length
+ * n+5  => Low byte of registers length
+ *
+ *
+ * // Classic publish
+ * 0    => Received packet identifier       => COMMUNICATION_PACKET_READ_MULTIPLE_REGISTER_STRUCTURE
+ * 1    => Register type
+ * 2    => High byte of register address
+ * 3    => Low byte of register address
+ * 4    => High byte of registers length
+ * 5    => Low byte of registers length
+ */
+void _communicationReadMultipleRegistersStructureHandler(
+    uint8_t * payload,
+    const uint16_t length,
+    const bool isBroadcast
+) {
+    // Position of register type is shifted by device SN when broadcasted
+    uint8_t byte_offset = 0;
+
+    if (isBroadcast && _communicationIsAddressedBySerialNumber(payload, length, 6, byte_offset) == false) {
+        return;
     }
 
-    uint8_t register_type = (uint8_t) data_payload[1];
+    uint8_t register_type = (uint8_t) payload[byte_offset + 1];
 
-    // Register read address
-    word register_address = (word) data_payload[2] << 8 | (word) data_payload[3];
+    // Register read start address
+    word register_address = (word) payload[byte_offset + 2] << 8 | (word) payload[byte_offset + 3];
 
-    bool result = false;
+    // Number of registers to read
+    word read_length = (word) payload[byte_offset + 4] << 8 | (word) payload[byte_offset + 5];
 
     switch (register_type)
     {
 
         #if REGISTER_MAX_INPUT_REGISTERS_SIZE
             case REGISTER_TYPE_INPUT:
-                result = _communicationReadSingleRegisterStructure(register_address, REGISTER_TYPE_INPUT);
+                _communicationReadMultipleRegistersStructure(payload, register_address, read_length, REGISTER_TYPE_INPUT);
                 break;
         #endif
 
         #if REGISTER_MAX_OUTPUT_REGISTERS_SIZE
             case REGISTER_TYPE_OUTPUT:
-                result = _communicationReadSingleRegisterStructure(register_address, REGISTER_TYPE_OUTPUT);
+                _communicationReadMultipleRegistersStructure(payload, register_address, read_length, REGISTER_TYPE_OUTPUT);
                 break;
         #endif
 
         #if REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
             case REGISTER_TYPE_ATTRIBUTE:
-                result = _communicationReadSingleRegisterStructure(register_address, REGISTER_TYPE_ATTRIBUTE);
+                _communicationReadMultipleRegistersStructure(payload, register_address, read_length, REGISTER_TYPE_ATTRIBUTE);
                 break;
         #endif
 
         default:
             #if DEBUG_COMMUNICATION_SUPPORT
-                DPRINTLN(F("[COMMUNICATION][ERR] Master is trying to read from undefined register type"));
+                DLOG(LOG_COMMUNICATION_UNDEFINED_TYPE, register_type);
             #endif
 
-            _communicationReplyWithException(payload);
-
-    }
+            _communicationReplyWithException(payload, COMMUNICATION_EXCEPTION_OUT_OF_RANGE);
 
-    if (result == false) {
-        _communicationReplyWithException(payload);
     }
 }
 
@@ -950,16 +1390,12 @@ void _communicationReadSingleRegisterStructureHandler(
 // -----------------------------------------------------------------------------
 
 /**
- * Parse received payload - Provide device info
- * 
- * 0 => Received packet identifier  => COMMUNICATION_PACKET_DISCOVER
+ * Device info is prepared in output buffer
+ *
+ * @return Length of reply
  */
-void _communicationDiscoverHandler(
-    uint8_t * payload,
-    const uint16_t length
-) {
-    memset(_communication_output_buffer, 0, PJON_PACKET_MAX_LENGTH);
-
+uint8_t _communicationBuildDiscoverReply()
+{
     // 0      => Packet identifier
     // 1      => Device bus address
     // 2      => Device packet max length
@@ -1091,409 +1527,1431 @@ void _communicationDiscoverHandler(
     byte_pointer++;
     byte_counter++;
 
-    #if DEBUG_COMMUNICATION_SUPPORT
-        // Reply to master
-        if (_communicationReplyToPacket(_communication_output_buffer, byte_counter) == false) {
-            DPRINTLN(F("[COMMUNICATION][ERR] Master could not receive device search request"));
-
-        } else {
-            DPRINTLN(F("[COMMUNICATION] Replied to master with device search request"));
-        }
-    #else
-        // Reply to master
-        _communicationReplyToPacket(_communication_output_buffer, byte_counter);
-    #endif
+    return byte_counter;
 }
 
-// -----------------------------------------------------------------------------
-// MASTER PING PONG
 // -----------------------------------------------------------------------------
 
 /**
- * Parse received payload - Master ping
- * 
- * 0 => Received packet identifier  => COMMUNICATION_PACKET_PING
+ * Slot of device discovery reply is picked from device SN hash, master is changing
+ * discovery round so devices with colliding slots are spread differently next round
  */
-void _communicationPingHandler(
-    uint8_t * payload,
-    uint16_t length
+uint8_t _communicationDiscoverSlot(
+    const uint8_t slotsCount,
+    const uint8_t round
 ) {
-    memset(_communication_output_buffer, 0, PJON_PACKET_MAX_LENGTH);
+    // FNV-1a
+    uint32_t hash = 2166136261UL;
 
-    // 0 => Packet identifier
-    _communication_output_buffer[0] = (char) COMMUNICATION_PACKET_PONG;
+    for (uint8_t i = 0; i < strlen(DEVICE_SERIAL_NO); i++) {
+        hash = (hash ^ (uint8_t) DEVICE_SERIAL_NO[i]) * 16777619UL;
+    }
+
+    hash = (hash ^ round) * 16777619UL;
+
+    return hash % slotsCount;
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Send discovery reply when its slot starts
+ */
+void _communicationDiscoverSlotHandle()
+{
+    // Leaving discoverable mode, next pairing starts from scratch
+    if (firmwareIsDiscoverable() == false) {
+        _communication_discover_pending = false;
+        _communication_discover_acknowledged = false;
+
+        return;
+    }
+
+    if (
+        _communication_discover_pending == false
+        || (millis() - _communication_discover_request) < _communication_discover_delay
+    ) {
+        return;
+    }
+
+    _communication_discover_pending = false;
 
     #if DEBUG_COMMUNICATION_SUPPORT
-        // Reply to master
-        if (_communicationReplyToPacket(_communication_output_buffer, 1) == false) {
-            // Device was not able to notify master about its address
-            DPRINTLN(F("[COMMUNICATION][ERR] Master could not receive device pong reply"));
+        // Notify master
+        if (_communicationSendPacket(COMMUNICATION_BUS_MASTER_ADDR, _communication_output_buffer, _communicationBuildDiscoverReply()) == false) {
+            DLOG(LOG_COMMUNICATION_DISCOVER_SLOT_NOT_RECEIVED);
 
         } else {
-            DPRINTLN(F("[COMMUNICATION] Replied to master with pong"));
+            DLOG(LOG_COMMUNICATION_DISCOVER_SLOT_REPLIED);
         }
     #else
-        // Reply to master
-        _communicationReplyToPacket(_communication_output_buffer, 1);
+        // Notify master
+        _communicationSendPacket(COMMUNICATION_BUS_MASTER_ADDR, _communication_output_buffer, _communicationBuildDiscoverReply());
     #endif
 }
 
+// -----------------------------------------------------------------------------
+
+/**
+ * Parse received payload - Provide device info
+ *
+ * 0 => Received packet identifier  => COMMUNICATION_PACKET_DISCOVER
+ * 1 => Count of reply slots        => Optional, device replies immediately without slots
+ * 2 => Discovery round             => Optional
+ */
+void _communicationDiscoverHandler(
+    uint8_t * payload,
+    const uint16_t length,
+    const bool isBroadcast
+) {
+    // Handle discovery packet only if device is discoverable
+    if (firmwareIsDiscoverable() == false) {
+        return;
+    }
+
+    // Master already knows this device, other devices could use the bus
+    if (_communication_discover_acknowledged) {
+        return;
+    }
+
+    uint8_t slots_count = length > 1 ? (uint8_t) payload[1] : 0;
+
+    if (slots_count > 1) {
+        uint8_t slot = _communicationDiscoverSlot(slots_count, length > 2 ? (uint8_t) payload[2] : 0);
+
+        #if DEBUG_COMMUNICATION_SUPPORT
+            DLOG(LOG_COMMUNICATION_DISCOVER_SLOT, slot);
+        #endif
+
+        _communication_discover_pending = true;
+        _communication_discover_request = millis();
+        _communication_discover_delay = (uint32_t) slot * COMMUNICATION_DISCOVER_SLOT_LENGTH;
+
+        return;
+    }
+
+    #if DEBUG_COMMUNICATION_SUPPORT
+        // Reply to master
+        if (_communicationReplyToPacket(_communication_output_buffer, _communicationBuildDiscoverReply()) == false) {
+            DLOG(LOG_COMMUNICATION_DISCOVER_NOT_RECEIVED);
+
+        } else {
+            DLOG(LOG_COMMUNICATION_DISCOVER_REPLIED);
+        }
+    #else
+        // Reply to master
+        _communicationReplyToPacket(_communication_output_buffer, _communicationBuildDiscoverReply());
+    #endif
+}
+
+// -----------------------------------------------------------------------------
+// MASTER PING PONG
+// -----------------------------------------------------------------------------
+
+/**
+ * Parse received payload - Master ping
+ * 
+ * 0 => Received packet identifier  => COMMUNICATION_PACKET_PING
+ */
+void _communicationPingHandler(
+    uint8_t * payload,
+    const uint16_t length,
+    const bool isBroadcast
+) {
+    // 0 => Packet identifier
+    _communication_output_buffer[0] = (char) COMMUNICATION_PACKET_PONG;
+
+    #if DEBUG_COMMUNICATION_SUPPORT
+        // Reply to master
+        if (_communicationReplyToPacket(_communication_output_buffer, 1) == false) {
+            // Device was not able to notify master about its address
+            DLOG(LOG_COMMUNICATION_PONG_NOT_RECEIVED);
+
+        } else {
+            DLOG(LOG_COMMUNICATION_PONG_REPLIED);
+        }
+    #else
+        // Reply to master
+        _communicationReplyToPacket(_communication_output_buffer, 1);
+    #endif
+}
+
+// -----------------------------------------------------------------------------
+// SCENES
+// -----------------------------------------------------------------------------
+
+#if RELAY_SCENES_SUPPORT
+/**
+ * Parse received payload - Scene broadcasted by master, all devices apply their own definition of it
+ * 
+ * 0    => Received packet identifier   => COMMUNICATION_PACKET_SCENE
+ * 1    => Scene index
+ */
+void _communicationSceneHandler(
+    uint8_t * payload,
+    const uint16_t length,
+    const bool isBroadcast
+) {
+    // Broadcast packets are not replied, unknown scene is only logged
+    if (relayApplyScene(payload[1]) == false) {
+        #if DEBUG_COMMUNICATION_SUPPORT
+            DLOG(LOG_COMMUNICATION_SCENE_UNKNOWN, payload[1]);
+        #endif
+    }
+}
+#endif
+
+// -----------------------------------------------------------------------------
+// PACKETS DISPATCHING
+// -----------------------------------------------------------------------------
+
+// Packets are indexed in two blocks, misc packets from 0x00 & registers packets from data space
+#define COMMUNICATION_PACKETS_MISC_SIZE     (COMMUNICATION_PACKET_DISCOVER + 1)
+#define COMMUNICATION_PACKETS_DATA_SIZE     (COMMUNICATION_PACKET_SCENE - COMMUNICATION_PACKET_DATA_SPACE + 1)
+
+const communication_packet_t _communication_packets[COMMUNICATION_PACKETS_MISC_SIZE + COMMUNICATION_PACKETS_DATA_SIZE] PROGMEM = {
+    // Packet identifier                                        Accepted addressing                                                                 Min length  Handler
+    {0x00,                                                      COMMUNICATION_PACKET_ADDRESSING_NONE,                                                0,          NULL},
+    {COMMUNICATION_PACKET_PING,                                 COMMUNICATION_PACKET_ADDRESSING_UNICAST,                                             1,          _communicationPingHandler},
+    {COMMUNICATION_PACKET_PONG,                                 COMMUNICATION_PACKET_ADDRESSING_NONE,                                                0,          NULL},
+    {COMMUNICATION_PACKET_EXCEPTION,                            COMMUNICATION_PACKET_ADDRESSING_NONE,                                                0,          NULL},
+    {COMMUNICATION_PACKET_DISCOVER,                             COMMUNICATION_PACKET_ADDRESSING_BROADCAST,                                           1,          _communicationDiscoverHandler},
+
+    {COMMUNICATION_PACKET_DATA_SPACE,                           COMMUNICATION_PACKET_ADDRESSING_NONE,                                                0,          NULL},
+
+    #if REGISTER_MAX_INPUT_REGISTERS_SIZE || REGISTER_MAX_OUTPUT_REGISTERS_SIZE || REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
+        {COMMUNICATION_PACKET_READ_SINGLE_REGISTER_VALUES,      COMMUNICATION_PACKET_ADDRESSING_UNICAST,                                             4,          _communicationReadSingleRegisterValueHandler},
+        {COMMUNICATION_PACKET_READ_MULTIPLE_REGISTERS_VALUES,   COMMUNICATION_PACKET_ADDRESSING_UNICAST,                                             6,          _communicationReadMultipleRegistersValuesHandler},
+    #else
+        {COMMUNICATION_PACKET_READ_SINGLE_REGISTER_VALUES,      COMMUNICATION_PACKET_ADDRESSING_NONE,                                                0,          NULL},
+        {COMMUNICATION_PACKET_READ_MULTIPLE_REGISTERS_VALUES,   COMMUNICATION_PACKET_ADDRESSING_NONE,                                                0,          NULL},
+    #endif
+
+    #if REGISTER_MAX_OUTPUT_REGISTERS_SIZE || REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
+        {COMMUNICATION_PACKET_WRITE_SINGLE_REGISTER_VALUE,      COMMUNICATION_PACKET_ADDRESSING_UNICAST | COMMUNICATION_PACKET_ADDRESSING_UNASSIGNED, 8,          _communicationWriteSingleRegisterValueHandler},
+        {COMMUNICATION_PACKET_WRITE_MULTIPLE_REGISTERS_VALUES,  COMMUNICATION_PACKET_ADDRESSING_UNICAST,                                             6,          _communicationWriteMultipleRegistersValuesHandler},
+    #else
+        {COMMUNICATION_PACKET_WRITE_SINGLE_REGISTER_VALUE,      COMMUNICATION_PACKET_ADDRESSING_NONE,                                                0,          NULL},
+        {COMMUNICATION_PACKET_WRITE_MULTIPLE_REGISTERS_VALUES,  COMMUNICATION_PACKET_ADDRESSING_NONE,                                                0,          NULL},
+    #endif
+
+    #if REGISTER_MAX_INPUT_REGISTERS_SIZE || REGISTER_MAX_OUTPUT_REGISTERS_SIZE || REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
+        {COMMUNICATION_PACKET_READ_SINGLE_REGISTER_STRUCTURE,   COMMUNICATION_PACKET_ADDRESSING_UNICAST | COMMUNICATION_PACKET_ADDRESSING_UNASSIGNED, 4,          _communicationReadSingleRegisterStructureHandler},
+    #else
+        {COMMUNICATION_PACKET_READ_SINGLE_REGISTER_STRUCTURE,   COMMUNICATION_PACKET_ADDRESSING_NONE,                                                0,          NULL},
+    #endif
+
+    #if REGISTER_MAX_INPUT_REGISTERS_SIZE || REGISTER_MAX_OUTPUT_REGISTERS_SIZE || REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
+        {COMMUNICATION_PACKET_READ_MULTIPLE_REGISTER_STRUCTURE, COMMUNICATION_PACKET_ADDRESSING_UNICAST | COMMUNICATION_PACKET_ADDRESSING_UNASSIGNED, 6,          _communicationReadMultipleRegistersStructureHandler},
+    #else
+        {COMMUNICATION_PACKET_READ_MULTIPLE_REGISTER_STRUCTURE, COMMUNICATION_PACKET_ADDRESSING_NONE,                                                0,          NULL},
+    #endif
+
+    {COMMUNICATION_PACKET_REPORT_SINGLE_REGISTER_VALUE,         COMMUNICATION_PACKET_ADDRESSING_NONE,                                                0,          NULL},
+    {COMMUNICATION_PACKET_REPORT_MULTIPLE_REGISTERS_VALUES,     COMMUNICATION_PACKET_ADDRESSING_NONE,                                                0,          NULL},
+
+    #if REGISTER_MAX_INPUT_REGISTERS_SIZE || REGISTER_MAX_OUTPUT_REGISTERS_SIZE || REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
+        {COMMUNICATION_PACKET_SUBSCRIBE_REGISTERS,              COMMUNICATION_PACKET_ADDRESSING_UNICAST,                                             14,         _communicationSubscribeRegistersHandler},
+    #else
+        {COMMUNICATION_PACKET_SUBSCRIBE_REGISTERS,              COMMUNICATION_PACKET_ADDRESSING_NONE,                                                0,          NULL},
+    #endif
+
+    {COMMUNICATION_PACKET_REPORT_ACKNOWLEDGE,                   COMMUNICATION_PACKET_ADDRESSING_UNICAST,                                             2,          _communicationReportAcknowledgeHandler},
+
+    #if RELAY_SCENES_SUPPORT
+        {COMMUNICATION_PACKET_SCENE,                            COMMUNICATION_PACKET_ADDRESSING_BROADCAST,                                           2,          _communicationSceneHandler},
+    #else
+        {COMMUNICATION_PACKET_SCENE,                            COMMUNICATION_PACKET_ADDRESSING_NONE,                                                0,          NULL},
+    #endif
+};
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Position of packet in dispatching table or INDEX_NONE for unknown packets
+ */
+uint8_t _communicationPacketIndex(
+    const uint8_t packetId
+) {
+    if (packetId < COMMUNICATION_PACKETS_MISC_SIZE) {
+        return packetId;
+    }
+
+    if (
+        packetId >= COMMUNICATION_PACKET_DATA_SPACE
+        && packetId < (COMMUNICATION_PACKET_DATA_SPACE + COMMUNICATION_PACKETS_DATA_SIZE)
+    ) {
+        return COMMUNICATION_PACKETS_MISC_SIZE + (packetId - COMMUNICATION_PACKET_DATA_SPACE);
+    }
+
+    return INDEX_NONE;
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Check packet against dispatching table & call its handler
+ */
+void _communicationDispatchPacket(
+    uint8_t * payload,
+    const uint16_t length,
+    const bool isBroadcast
+) {
+    uint8_t packet_index = _communicationPacketIndex((uint8_t) payload[0]);
+
+    communication_packet_t packet = {0x00, COMMUNICATION_PACKET_ADDRESSING_NONE, 0, NULL};
+
+    if (packet_index != INDEX_NONE) {
+        memcpy_P(&packet, &_communication_packets[packet_index], sizeof(communication_packet_t));
+    }
+
+    if (isBroadcast) {
+        // Unknown broadcast packets are silently ignored
+        if ((packet.addressing & (COMMUNICATION_PACKET_ADDRESSING_BROADCAST | COMMUNICATION_PACKET_ADDRESSING_UNASSIGNED)) == 0) {
+            return;
+        }
+
+        // Some broadcast packets are accepted only by device without address
+        if (
+            (packet.addressing & COMMUNICATION_PACKET_ADDRESSING_BROADCAST) == 0
+            && communicationAssignedAddress() != PJON_NOT_ASSIGNED
+        ) {
+            return;
+        }
+
+    } else if ((packet.addressing & COMMUNICATION_PACKET_ADDRESSING_UNICAST) == 0) {
+        #if DEBUG_COMMUNICATION_SUPPORT
+            DLOG(LOG_COMMUNICATION_UNSUPPORTED_PACKET, payload[0]);
+        #endif
+
+        _communicationReplyWithException(payload, COMMUNICATION_EXCEPTION_UNSUPPORTED_PACKET);
+
+        return;
+    }
+
+    if (length < packet.min_length) {
+        #if DEBUG_COMMUNICATION_SUPPORT
+            DLOG(LOG_COMMUNICATION_TOO_SHORT, payload[0]);
+        #endif
+
+        if (isBroadcast == false) {
+            _communicationReplyWithException(payload, COMMUNICATION_EXCEPTION_BAD_LENGTH);
+        }
+
+        return;
+    }
+
+    #if STATS_SUPPORT
+        statsPacketHandled(packet.packet_id);
+    #endif
+
+    packet.handler(payload, length, isBroadcast);
+}
+
+// -----------------------------------------------------------------------------
+// BUS CAPTURE
+// -----------------------------------------------------------------------------
+
+#if COMMUNICATION_CAPTURE_SUPPORT
+void _communicationCapturePush(
+    const uint8_t value
+) {
+    _communication_capture_buffer[_communication_capture_head] = value;
+
+    _communication_capture_head = (_communication_capture_head + 1) % COMMUNICATION_CAPTURE_BUFFER_SIZE;
+    _communication_capture_used++;
+}
+
+// -----------------------------------------------------------------------------
+
+uint8_t _communicationCapturePop()
+{
+    uint8_t value = _communication_capture_buffer[_communication_capture_tail];
+
+    _communication_capture_tail = (_communication_capture_tail + 1) % COMMUNICATION_CAPTURE_BUFFER_SIZE;
+    _communication_capture_used--;
+
+    return value;
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Store bus frame into capture buffer, it is not written to serial port here
+ * as it would delay bus handling by whole line transmission
+ *
+ * 0-3  => Timestamp, device uptime in ms
+ * 4    => Direction, R for received & T for transmitted frame
+ * 5    => Sender address, 255 when frame was without sender info
+ * 6    => Receiver address, 0 for broadcast
+ * 7    => Frame length
+ * 8-n  => Whole PJON payload: protocol version, packet & terminator
+ */
+void _communicationCaptureFrame(
+    const char direction,
+    const uint8_t sender,
+    const uint8_t receiver,
+    const uint8_t * frame,
+    const uint16_t length
+) {
+    if (
+        length > 0xFF
+        || (COMMUNICATION_CAPTURE_BUFFER_SIZE - _communication_capture_used) < (COMMUNICATION_CAPTURE_RECORD_HEADER_SIZE + length)
+    ) {
+        _communication_capture_dropped++;
+
+        return;
+    }
+
+    uint32_t timestamp = millis();
+
+    for (uint8_t i = 0; i < 4; i++) {
+        _communicationCapturePush((uint8_t) (timestamp >> (8 * i)));
+    }
+
+    _communicationCapturePush((uint8_t) direction);
+    _communicationCapturePush(sender);
+    _communicationCapturePush(receiver);
+    _communicationCapturePush((uint8_t) length);
+
+    for (uint16_t i = 0; i < length; i++) {
+        _communicationCapturePush(frame[i]);
+    }
+
+    #if DEBUG_COMMUNICATION_SUPPORT
+        if (_communication_capture_dropped > 0) {
+            DLOG(LOG_COMMUNICATION_CAPTURE_DROPPED, _communication_capture_dropped);
+
+            _communication_capture_dropped = 0;
+        }
+    #endif
+}
+
+// -----------------------------------------------------------------------------
+
+void _communicationCaptureAppendNumber(
+    uint32_t value
+) {
+    char digits[10];
+    uint8_t count = 0;
+
+    do {
+        digits[count++] = (char) ('0' + (value % 10));
+
+        value = value / 10;
+    } while (value > 0);
+
+    while (count > 0) {
+        _communication_capture_line_header[_communication_capture_line_header_length++] = digits[--count];
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Take record header from buffer and prepare text line of it:
+ *
+ * @<timestamp>,<direction>,<sender>,<receiver>,<frame in hex>
+ */
+void _communicationCaptureStartLine()
+{
+    uint32_t timestamp = 0;
+
+    for (uint8_t i = 0; i < 4; i++) {
+        timestamp |= (uint32_t) _communicationCapturePop() << (8 * i);
+    }
+
+    char direction = (char) _communicationCapturePop();
+    uint8_t sender = _communicationCapturePop();
+    uint8_t receiver = _communicationCapturePop();
+    uint8_t frame_length = _communicationCapturePop();
+
+    _communication_capture_line_header_length = 0;
+
+    _communication_capture_line_header[_communication_capture_line_header_length++] = COMMUNICATION_CAPTURE_MARKER[0];
+    _communicationCaptureAppendNumber(timestamp);
+    _communication_capture_line_header[_communication_capture_line_header_length++] = ',';
+    _communication_capture_line_header[_communication_capture_line_header_length++] = direction;
+    _communication_capture_line_header[_communication_capture_line_header_length++] = ',';
+    _communicationCaptureAppendNumber(sender);
+    _communication_capture_line_header[_communication_capture_line_header_length++] = ',';
+    _communicationCaptureAppendNumber(receiver);
+    _communication_capture_line_header[_communication_capture_line_header_length++] = ',';
+
+    // Header, two hex digits per frame byte & line end
+    _communication_capture_line_length = _communication_capture_line_header_length + (2 * frame_length) + 2;
+    _communication_capture_line_position = 0;
+}
+
+// -----------------------------------------------------------------------------
+
+char _communicationCaptureLineCharacter()
+{
+    const char hex_digits[] = "0123456789ABCDEF";
+
+    uint16_t position = _communication_capture_line_position;
+
+    if (position < _communication_capture_line_header_length) {
+        return _communication_capture_line_header[position];
+    }
+
+    if (position >= _communication_capture_line_length - 2) {
+        return position == _communication_capture_line_length - 2 ? '\r' : '\n';
+    }
+
+    // Frame byte is removed from buffer with its second digit
+    if (((position - _communication_capture_line_header_length) % 2) == 0) {
+        return hex_digits[_communication_capture_buffer[_communication_capture_tail] >> 4];
+    }
+
+    return hex_digits[_communicationCapturePop() & 0x0F];
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Write captured lines to serial port, non blocking write is stopped when serial transmit buffer is full
+ *
+ * @return True when no line is written partially
+ */
+bool _communicationCaptureWrite(
+    const bool blocking
+) {
+    while (blocking || Serial.availableForWrite() > 0) {
+        if (_communication_capture_line_length == 0) {
+            if (_communication_capture_used == 0) {
+                return true;
+            }
+
+            _communicationCaptureStartLine();
+        }
+
+        Serial.write((uint8_t) _communicationCaptureLineCharacter());
+
+        _communication_capture_line_position++;
+
+        if (_communication_capture_line_position == _communication_capture_line_length) {
+            _communication_capture_line_length = 0;
+        }
+    }
+
+    return _communication_capture_line_length == 0;
+}
+#endif
+
 // -----------------------------------------------------------------------------
 // COMMUNICATION
 // -----------------------------------------------------------------------------
 
-void _communicationReceiverHandler(
-    uint8_t * payload,
-    const uint16_t length,
-    const PJON_Packet_Info &packetInfo
+void _communicationReceiverHandler(
+    uint8_t * payload,
+    const uint16_t length,
+    const PJON_Packet_Info &packetInfo
+) {
+    #if COMMUNICATION_CAPTURE_SUPPORT
+        _communicationCaptureFrame(
+            COMMUNICATION_CAPTURE_RECEIVED,
+            (packetInfo.header & PJON_TX_INFO_BIT) ? packetInfo.sender_id : PJON_NOT_ASSIGNED,
+            packetInfo.receiver_id,
+            payload,
+            length
+        );
+    #endif
+
+    // Device is not in running or pairing mode, all received packets are ignored
+    if (firmwareIsRunning() == false) {
+        return;
+    }
+
+    // Protocol version, packet identifier and terminator are mandatory
+    if (length < 3) {
+        #if DEBUG_COMMUNICATION_SUPPORT
+            DLOG(LOG_COMMUNICATION_WITHOUT_CONTENT);
+        #endif
+
+        return;
+    }
+
+    // Protocol version must be on first byte
+    uint8_t protocol_version = (uint8_t) payload[0];
+
+    if (protocol_version != COMMUNICATION_PROTOCOL_VERSION) {
+        #if DEBUG_COMMUNICATION_SUPPORT
+            DLOG(LOG_COMMUNICATION_UNSUPPORTED_VERSION, protocol_version);
+        #endif
+
+        return;
+    }
+
+    // Packet is handled in place, without protocol version and terminator
+    uint8_t * data_payload = &payload[1];
+    uint16_t data_length = length - 2;
+
+    uint8_t sender_address = PJON_NOT_ASSIGNED;
+
+    // Get sender address from header
+    if (packetInfo.header & PJON_TX_INFO_BIT) {
+        sender_address = packetInfo.sender_id;
+    }
+
+    #if DEBUG_COMMUNICATION_SUPPORT
+        // Packed ID must be on second byte
+        DLOG(LOG_COMMUNICATION_RECEIVED, data_payload[0], data_length, sender_address);
+    #endif
+
+    uint8_t receiver_address = packetInfo.receiver_id;
+
+    // Only packets from master are accepted
+    if (sender_address != COMMUNICATION_BUS_MASTER_ADDR) {
+        #if DEBUG_COMMUNICATION_SUPPORT
+            DLOG(LOG_COMMUNICATION_UNKNOWN_MASTER, sender_address);
+        #endif
+
+        return;
+    }
+
+    // Reset master lost detection
+    _communication_master_lost = false;
+    _communication_master_last_request = millis();
+
+    _communicationDispatchPacket(data_payload, data_length, receiver_address == PJON_BROADCAST);
+
+    #if DEBUG_COMMUNICATION_SUPPORT
+        DLOG(LOG_COMMUNICATION_HANDLED);
+    #endif
+}
+
+// -----------------------------------------------------------------------------
+
+void _communicationErrorHandler(
+    const uint8_t code,
+    const uint16_t data,
+    void * customPointer
+) {
+    #if STATS_SUPPORT
+        if (code == PJON_PACKETS_BUFFER_FULL) {
+            statsIncrement(STATS_COUNTER_BUFFER_FULL);
+        }
+    #endif
+
+    #if DEBUG_COMMUNICATION_SUPPORT
+        if (code == PJON_CONNECTION_LOST) {
+            _communication_master_lost = true;
+
+            DLOG(LOG_COMMUNICATION_CONNECTION_LOST);
+
+        } else if (code == PJON_PACKETS_BUFFER_FULL) {
+            DLOG(LOG_COMMUNICATION_BUFFER_FULL);
+
+        } else if (code == PJON_CONTENT_TOO_LONG) {
+            DLOG(LOG_COMMUNICATION_CONTENT_TOO_LONG);
+
+        } else {
+            DLOG(LOG_COMMUNICATION_UNKNOWN_ERROR, code);
+        }
+    #endif
+}
+// -----------------------------------------------------------------------------
+
+uint16_t _communicationFinalizeAndSendPacket(
+    const char * payload,
+    const uint8_t length,
+    const uint8_t address,
+    const bool isReply
+) {
+    uint16_t final_length = length + 2;
+
+    if (final_length > PJON_PACKET_MAX_LENGTH) {
+        return PJON_CONTENT_TOO_LONG;
+    }
+
+    // Packets are built in place, only payloads from other buffers have to be copied
+    if (payload != _communication_output_buffer) {
+        memmove(_communication_output_buffer, payload, length);
+    }
+
+    // Add protocol version
+    _communication_output_frame[0] = COMMUNICATION_PROTOCOL_VERSION;
+
+    // Be sure to set the null terminator!!!
+    _communication_output_frame[length + 1] = COMMUNICATION_PACKET_TERMINATOR;
+
+    uint16_t result;
+
+    if (isReply) {
+        result = _communication_bus.reply(
+            _communication_output_frame,    // Content
+            final_length                    // Content length
+        );
+
+    } else {
+        result = _communication_bus.send_packet(
+            address,                        // Recepient address
+            _communication_output_frame,    // Content
+            final_length                    // Content length
+        );
+    }
+
+    #if STATS_SUPPORT
+        statsPacketSent(result);
+    #endif
+
+    #if COMMUNICATION_CAPTURE_SUPPORT
+        // Only packets accepted from master are replied
+        _communicationCaptureFrame(
+            COMMUNICATION_CAPTURE_TRANSMITTED,
+            _communication_bus.device_id(),
+            isReply ? COMMUNICATION_BUS_MASTER_ADDR : address,
+            (const uint8_t *) _communication_output_frame,
+            final_length
+        );
+    #endif
+
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+
+uint16_t _communicationFinalizeAndSendPacket(
+    const char * payload,
+    const uint8_t length,
+    const uint8_t address
+) {
+    return _communicationFinalizeAndSendPacket(payload, length, address, false);
+}
+
+// -----------------------------------------------------------------------------
+
+uint16_t _communicationFinalizeAndSendPacket(
+    const char * payload,
+    const uint8_t length,
+    const bool isReply
+) {
+    return _communicationFinalizeAndSendPacket(payload, length, 0, isReply);
+}
+
+// -----------------------------------------------------------------------------
+
+bool _communicationSendPacket(
+    const uint8_t address,
+    const char * payload,
+    const uint8_t length
+) {
+    uint16_t result = _communicationFinalizeAndSendPacket(payload, length, address);
+
+    if (result != PJON_ACK) {
+        if (result == PJON_BUSY ) {
+            #if DEBUG_COMMUNICATION_SUPPORT
+                DLOG(LOG_COMMUNICATION_SEND_BUSY, address, (uint8_t) payload[0]);
+            #endif
+
+        } else if (result == PJON_FAIL) {
+            #if DEBUG_COMMUNICATION_SUPPORT
+                DLOG(LOG_COMMUNICATION_SEND_FAILED, address, (uint8_t) payload[0]);
+            #endif
+
+        } else {
+            #if DEBUG_COMMUNICATION_SUPPORT
+                DLOG(LOG_COMMUNICATION_SEND_ERROR, address, (uint8_t) payload[0]);
+            #endif
+        }
+
+        return false;
+    }
+
+    if (address == PJON_BROADCAST) {
+        #if DEBUG_COMMUNICATION_SUPPORT
+            DLOG(LOG_COMMUNICATION_SENT_BROADCAST, (uint8_t) payload[0]);
+        #endif
+
+    } else {
+        #if DEBUG_COMMUNICATION_SUPPORT
+            DLOG(LOG_COMMUNICATION_SENT, (uint8_t) payload[0], address);
+        #endif
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool _communicationReplyToPacket(
+    char * payload,
+    const uint8_t length
 ) {
-    // Device is not in running or pairing mode, all received packets are ignored
-    if (firmwareIsRunning() == false) {
-        return;
+    #if DEBUG_COMMUNICATION_SUPPORT
+        DLOG(LOG_COMMUNICATION_PREPARING_REPLY, (uint8_t) payload[0]);
+    #endif
+
+    uint16_t result =_communicationFinalizeAndSendPacket(payload, length, true);
+
+    if (result == PJON_FAIL) {
+        #if DEBUG_COMMUNICATION_SUPPORT
+            DLOG(LOG_COMMUNICATION_REPLY_FAILED);
+        #endif
+
+        return false;
     }
 
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool _communicationBroadcastPacket(
+    char * payload,
+    const uint8_t length
+) {
     #if DEBUG_COMMUNICATION_SUPPORT
-        DPRINTLN();
-        DPRINTLN(F("[COMMUNICATION] ==============="));
-        DPRINTLN(F("[COMMUNICATION] Received packet"));
-        DPRINTLN(F("[COMMUNICATION] ==============="));
+        DLOG(LOG_COMMUNICATION_PREPARING_BROADCAST, (uint8_t) payload[0]);
     #endif
 
-    if (length <= 0) {
+    uint8_t address = PJON_BROADCAST;
+
+    uint16_t result = _communicationFinalizeAndSendPacket(payload, length, address);
+
+    if (result == PJON_FAIL) {
         #if DEBUG_COMMUNICATION_SUPPORT
-            DPRINTLN(F("[COMMUNICATION][ERR] Received packet is without content"));
+            DLOG(LOG_COMMUNICATION_BROADCAST_FAILED);
         #endif
 
+        return false;
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// SUBSCRIBING REGISTERS
+// -----------------------------------------------------------------------------
+
+/**
+ * Subscription covering given register or INDEX_NONE, first matching subscription is used
+ */
+uint8_t _communicationSubscriptionIndex(
+    const uint8_t registerType,
+    const uint8_t registerAddress
+) {
+    for (uint8_t i = 0; i < COMMUNICATION_SUBSCRIPTIONS_SIZE; i++) {
+        if (
+            _communication_subscriptions[i].registers_count > 0
+            && _communication_subscriptions[i].register_type == registerType
+            && registerAddress >= _communication_subscriptions[i].register_address
+            && registerAddress < (_communication_subscriptions[i].register_address + _communication_subscriptions[i].registers_count)
+        ) {
+            return i;
+        }
+    }
+
+    return INDEX_NONE;
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Compare values by their data type, deadband is stored in the same data type
+ * Values without numeric meaning are always over deadband
+ */
+bool _communicationIsOverDeadband(
+    const uint8_t dataType,
+    const uint8_t * value,
+    const uint8_t * reported,
+    const uint8_t * deadband
+) {
+    switch (dataType)
+    {
+        case REGISTER_DATA_TYPE_UINT8:
+        case REGISTER_DATA_TYPE_UINT16:
+        case REGISTER_DATA_TYPE_UINT32:
+        {
+            UINT32_UNION_t a = { 0 }, b = { 0 }, d = { 0 };
+
+            memcpy(a.bytes, value, registerGetDataTypeSize(dataType));
+            memcpy(b.bytes, reported, registerGetDataTypeSize(dataType));
+            memcpy(d.bytes, deadband, registerGetDataTypeSize(dataType));
+
+            return (a.number > b.number ? a.number - b.number : b.number - a.number) >= d.number;
+        }
+
+        case REGISTER_DATA_TYPE_INT8:
+        {
+            INT8_UNION_t a, b, d;
+
+            memcpy(a.bytes, value, 1);
+            memcpy(b.bytes, reported, 1);
+            memcpy(d.bytes, deadband, 1);
+
+            return abs((int16_t) a.number - b.number) >= abs((int16_t) d.number);
+        }
+
+        case REGISTER_DATA_TYPE_INT16:
+        {
+            INT16_UNION_t a, b, d;
+
+            memcpy(a.bytes, value, 2);
+            memcpy(b.bytes, reported, 2);
+            memcpy(d.bytes, deadband, 2);
+
+            return labs((int32_t) a.number - b.number) >= labs((int32_t) d.number);
+        }
+
+        case REGISTER_DATA_TYPE_INT32:
+        {
+            INT32_UNION_t a, b, d;
+
+            memcpy(a.bytes, value, 4);
+            memcpy(b.bytes, reported, 4);
+            memcpy(d.bytes, deadband, 4);
+
+            // Difference is computed unsigned, so it could not overflow
+            uint32_t difference = a.number > b.number ? (uint32_t) a.number - (uint32_t) b.number : (uint32_t) b.number - (uint32_t) a.number;
+
+            return difference >= (uint32_t) labs(d.number);
+        }
+
+        case REGISTER_DATA_TYPE_FLOAT32:
+        {
+            FLOAT32_UNION_t a, b, d;
+
+            memcpy(a.bytes, value, 4);
+            memcpy(b.bytes, reported, 4);
+            memcpy(d.bytes, deadband, 4);
+
+            return fabs(a.number - b.number) >= fabs(d.number);
+        }
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Changed register is reported when it is not subscribed or its change is over subscription deadband
+ */
+bool _communicationSubscriptionIsSignificant(
+    const uint8_t registerType,
+    const uint8_t registerAddress
+) {
+    uint8_t index = _communicationSubscriptionIndex(registerType, registerAddress);
+
+    if (index == INDEX_NONE) {
+        return true;
+    }
+
+    uint8_t value[4] = { 0, 0, 0, 0 };
+
+    if (registerReadRegister(registerType, registerAddress, value) == false) {
+        return false;
+    }
+
+    return _communicationIsOverDeadband(
+        registerGetRegisterDataType(registerType, registerAddress),
+        value,
+        _communication_reported_values[_communicationReportOutboxIndex(registerType, registerAddress)],
+        _communication_subscriptions[index].deadband
+    );
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Subscribed registers are reported at most once per subscription min interval
+ */
+bool _communicationSubscriptionIsDue(
+    const uint8_t registerType,
+    const uint8_t registerAddress
+) {
+    uint8_t index = _communicationSubscriptionIndex(registerType, registerAddress);
+
+    if (index == INDEX_NONE) {
+        return true;
+    }
+
+    return (millis() - _communication_subscriptions[index].last_report) >= _communication_subscriptions[index].min_interval;
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Register value was delivered to master, it is new base for deadband
+ */
+void _communicationSubscriptionReported(
+    const uint8_t registerType,
+    const uint8_t registerAddress
+) {
+    uint8_t index = _communicationSubscriptionIndex(registerType, registerAddress);
+
+    if (index == INDEX_NONE) {
         return;
     }
 
-    #if DEBUG_COMMUNICATION_SUPPORT
-        for (uint8_t i = 0; i < length; i++) {
-            DPRINT(F("[COMMUNICATION] RAW DATA:"));
-            DPRINT((uint8_t) payload[i]);
-            DPRINTLN();
+    _communication_subscriptions[index].last_report = millis();
+
+    registerReadRegister(registerType, registerAddress, _communication_reported_values[_communicationReportOutboxIndex(registerType, registerAddress)]);
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Subscribed registers ranges without report for max interval are reported again
+ */
+void _communicationSubscriptionsHeartbeat()
+{
+    for (uint8_t i = 0; i < COMMUNICATION_SUBSCRIPTIONS_SIZE; i++) {
+        if (
+            _communication_subscriptions[i].registers_count == 0
+            || _communication_subscriptions[i].max_interval == 0
+            || (millis() - _communication_subscriptions[i].last_report) < ((uint32_t) _communication_subscriptions[i].max_interval * 1000)
+        ) {
+            continue;
         }
-    #endif
 
-    // Protocol version must be on first byte
-    uint8_t protocol_version = (uint8_t) payload[0];
+        for (uint8_t j = 0; j < _communication_subscriptions[i].registers_count; j++) {
+            _communicationReportOutboxMark(_communication_subscriptions[i].register_type, _communication_subscriptions[i].register_address + j, true);
+        }
+    }
+}
 
-    if (protocol_version != COMMUNICATION_PROTOCOL_VERSION) {
+// -----------------------------------------------------------------------------
+
+/**
+ * Parse received payload - Subscribe registers range
+ *
+ * 0        => Received packet identifier       => COMMUNICATION_PACKET_SUBSCRIBE_REGISTERS
+ * 1        => Register type
+ * 2        => High byte of register address
+ * 3        => Low byte of register address
+ * 4        => High byte of registers length    => 0 cancels subscription of range starting at address
+ * 5        => Low byte of registers length
+ * 6        => High byte of min report interval in ms
+ * 7        => Low byte of min report interval in ms
+ * 8        => High byte of max report interval in s    => Heartbeat, 0 disables it
+ * 9        => Low byte of max report interval in s
+ * 10-13    => Deadband in register data type
+ */
+void _communicationSubscribeRegistersHandler(
+    uint8_t * payload,
+    const uint16_t length,
+    const bool isBroadcast
+) {
+    uint8_t register_type = (uint8_t) payload[1];
+
+    // Subscribed range start address
+    word register_address = (word) payload[2] << 8 | (word) payload[3];
+
+    // Number of subscribed registers
+    word registers_length = (word) payload[4] << 8 | (word) payload[5];
+
+    if (
+        register_address >= registerGetRegistersSize(register_type)
+        || ((uint32_t) register_address + registers_length) > registerGetRegistersSize(register_type)
+    ) {
         #if DEBUG_COMMUNICATION_SUPPORT
-            DPRINT(F("[COMMUNICATION] Received packet for unsupported version "));
-            DPRINT(protocol_version);
-            DPRINTLN();
+            DLOG(LOG_COMMUNICATION_SUBSCRIBE_OUT_OF_RANGE);
         #endif
 
+        _communicationReplyWithException(payload, COMMUNICATION_EXCEPTION_OUT_OF_RANGE);
+
         return;
     }
 
-    uint16_t data_length = length - 2;
+    // Range is resubscribed in place
+    uint8_t index = INDEX_NONE;
+
+    for (uint8_t i = 0; i < COMMUNICATION_SUBSCRIPTIONS_SIZE; i++) {
+        if (
+            _communication_subscriptions[i].registers_count > 0
+            && _communication_subscriptions[i].register_type == register_type
+            && _communication_subscriptions[i].register_address == register_address
+        ) {
+            index = i;
+
+            break;
+
+        } else if (index == INDEX_NONE && _communication_subscriptions[i].registers_count == 0) {
+            index = i;
+        }
+    }
 
-    uint8_t data_payload[data_length];
+    if (index == INDEX_NONE) {
+        #if DEBUG_COMMUNICATION_SUPPORT
+            DLOG(LOG_COMMUNICATION_SUBSCRIPTIONS_FULL);
+        #endif
+
+        _communicationReplyWithException(payload, COMMUNICATION_EXCEPTION_BUSY);
+
+        return;
+    }
 
-    uint8_t byte_position = 0;
+    _communication_subscriptions[index].register_type = register_type;
+    _communication_subscriptions[index].register_address = (uint8_t) register_address;
+    _communication_subscriptions[index].registers_count = (uint8_t) registers_length;
+    _communication_subscriptions[index].min_interval = (uint16_t) payload[6] << 8 | (uint16_t) payload[7];
+    _communication_subscriptions[index].max_interval = (uint16_t) payload[8] << 8 | (uint16_t) payload[9];
+    _communication_subscriptions[index].last_report = millis() - _communication_subscriptions[index].min_interval;
 
-    for (uint8_t i = 1; i < length - 1; i++){
-        data_payload[byte_position] = payload[i];
+    memcpy(_communication_subscriptions[index].deadband, &payload[10], 4);
 
-        byte_position++;
+    // Master gets actual values of whole range, they are base for deadband
+    for (uint8_t i = 0; i < registers_length; i++) {
+        registerReadRegister(register_type, register_address + i, _communication_reported_values[_communicationReportOutboxIndex(register_type, register_address + i)]);
+
+        _communicationReportOutboxMark(register_type, register_address + i, true);
     }
 
     #if DEBUG_COMMUNICATION_SUPPORT
-        for (uint8_t i = 0; i < data_length; i++) {
-            DPRINT(F("[COMMUNICATION] DATA:"));
-            DPRINT((uint8_t) data_payload[i]);
-            DPRINTLN();
-        }
+        DLOG(LOG_COMMUNICATION_SUBSCRIBED, registers_length, register_address);
     #endif
 
-    // Packed ID must be on second byte
-    uint8_t packet_id = (uint8_t) data_payload[0];
+    // 0 => Packet identifier
+    // 1 => Register type
+    // 2 => High byte of register address
+    // 3 => Low byte of register address
+    // 4 => High byte of registers length
+    // 5 => Low byte of registers length
+    _communication_output_buffer[0] = (char) COMMUNICATION_PACKET_SUBSCRIBE_REGISTERS;
+    _communication_output_buffer[1] = (char) register_type;
+    _communication_output_buffer[2] = (char) (register_address >> 8);
+    _communication_output_buffer[3] = (char) (register_address & 0xFF);
+    _communication_output_buffer[4] = (char) (registers_length >> 8);
+    _communication_output_buffer[5] = (char) (registers_length & 0xFF);
 
     #if DEBUG_COMMUNICATION_SUPPORT
-        DPRINT(F("[COMMUNICATION] Received packet: "));
-        DPRINTLN(packet_id);
+        // Reply to master
+        if (_communicationReplyToPacket(_communication_output_buffer, 6) == false) {
+            DLOG(LOG_COMMUNICATION_SUBSCRIBE_NOT_RECEIVED);
+
+        } else {
+            DLOG(LOG_COMMUNICATION_SUBSCRIBE_REPLIED);
+        }
+    #else
+        // Reply to master
+        _communicationReplyToPacket(_communication_output_buffer, 6);
     #endif
+}
 
-    uint8_t sender_address = PJON_NOT_ASSIGNED;
+// -----------------------------------------------------------------------------
+// REPORTING REGISTERS
+// -----------------------------------------------------------------------------
 
-    // Get sender address from header
-    if (packetInfo.header & PJON_TX_INFO_BIT) {
-        sender_address = packetInfo.sender_id;
+/**
+ * Position of register in reporting outbox, registers types are stored one after another
+ */
+int16_t _communicationReportOutboxIndex(
+    const uint8_t registerType,
+    const uint8_t registerAddress
+) {
+    if (registerAddress >= registerGetRegistersSize(registerType)) {
+        return -1;
     }
 
-    uint8_t receiver_address = packetInfo.receiver_id;
+    if (registerType == REGISTER_TYPE_INPUT) {
+        return registerAddress;
 
-    // Only packets from master are accepted
-    if (sender_address != COMMUNICATION_BUS_MASTER_ADDR) {
-        #if DEBUG_COMMUNICATION_SUPPORT
-            DPRINT(F("[COMMUNICATION][ERR] Received packet from unknown master address: "));
-            DPRINTLN(sender_address);
-        #endif
+    } else if (registerType == REGISTER_TYPE_OUTPUT) {
+        return REGISTER_MAX_INPUT_REGISTERS_SIZE + registerAddress;
+
+    } else if (registerType == REGISTER_TYPE_ATTRIBUTE) {
+        return REGISTER_MAX_INPUT_REGISTERS_SIZE + REGISTER_MAX_OUTPUT_REGISTERS_SIZE + registerAddress;
+    }
+
+    return -1;
+}
+
+// -----------------------------------------------------------------------------
+
+bool _communicationReportOutboxIsMarked(
+    const uint8_t registerType,
+    const uint8_t registerAddress
+) {
+    int16_t index = _communicationReportOutboxIndex(registerType, registerAddress);
+
+    if (index < 0) {
+        return false;
+    }
+
+    return (_communication_report_outbox[index / 8] & (1 << (index % 8))) != 0;
+}
+
+// -----------------------------------------------------------------------------
+
+void _communicationReportOutboxMark(
+    const uint8_t registerType,
+    const uint8_t registerAddress,
+    const bool state
+) {
+    int16_t index = _communicationReportOutboxIndex(registerType, registerAddress);
 
+    if (index < 0) {
         return;
     }
 
-    // Reset master lost detection
-    _communication_master_lost = false;
-    _communication_master_last_request = millis();
+    if (state) {
+        _communication_report_outbox[index / 8] |= (1 << (index % 8));
 
-    if (receiver_address == PJON_BROADCAST) {
-        switch (packet_id)
-        {
+    } else {
+        _communication_report_outbox[index / 8] &= ~(1 << (index % 8));
+    }
+}
 
-            case COMMUNICATION_PACKET_DISCOVER:
-                // Handle discovery packet only if device is discoverable
-                if (firmwareIsDiscoverable() == true) {
-                    _communicationDiscoverHandler(data_payload, data_length);
-                }
-                break;
+// -----------------------------------------------------------------------------
 
-            /**
-             * REGISTERS
-             */
-
-            #if REGISTER_MAX_INPUT_REGISTERS_SIZE || REGISTER_MAX_OUTPUT_REGISTERS_SIZE || REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
-                case COMMUNICATION_PACKET_READ_SINGLE_REGISTER_STRUCTURE:
-                    // Handle register structure packet broadcas only if address is not assigned
-                    if (communicationAssignedAddress() == PJON_NOT_ASSIGNED) {
-                        _communicationReadSingleRegisterStructureHandler(data_payload, data_length, true);
-                    }
-                    break;
-            #endif
+void _communicationReportInflightMark(
+    const uint8_t registerType,
+    const uint8_t registerAddress
+) {
+    int16_t index = _communicationReportOutboxIndex(registerType, registerAddress);
 
-            #if REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
-                case COMMUNICATION_PACKET_WRITE_SINGLE_REGISTER_VALUE:
-                    // Handle register write packet broadcas only if address is not assigned
-                    if (communicationAssignedAddress() == PJON_NOT_ASSIGNED) {
-                        _communicationWriteSingleAttributeRegisterValueFromBroadcastHandler(data_payload);
-                    }
-                    break;
-            #endif
+    if (index < 0) {
+        return;
+    }
+
+    _communication_report_inflight[index / 8] |= (1 << (index % 8));
+}
+
+// -----------------------------------------------------------------------------
 
+bool _communicationReportIsInflight()
+{
+    for (uint8_t i = 0; i < COMMUNICATION_REPORT_OUTBOX_SIZE; i++) {
+        if (_communication_report_inflight[i] != 0) {
+            return true;
         }
+    }
 
-    } else {
-        switch (packet_id)
-        {
+    return false;
+}
+
+// -----------------------------------------------------------------------------
 
-            /**
-             * MISC
-             */
+/**
+ * Sequence number for next report, zero is skipped so it is never acknowledged by mistake
+ */
+uint8_t _communicationReportNextSequence()
+{
+    return _communication_report_sequence == 255 ? 1 : (_communication_report_sequence + 1);
+}
 
-            case COMMUNICATION_PACKET_PING:
-                _communicationPingHandler(data_payload, data_length);
-                break;
+// -----------------------------------------------------------------------------
 
-            /**
-             * REGISTERS
-             */
+/**
+ * New report packet was sent, its sequence number is expected in master acknowledge
+ */
+void _communicationReportSent()
+{
+    _communication_report_sequence = _communicationReportNextSequence();
+    _communication_report_sent = millis();
+}
 
-            #if REGISTER_MAX_INPUT_REGISTERS_SIZE || REGISTER_MAX_OUTPUT_REGISTERS_SIZE || REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
-                case COMMUNICATION_PACKET_READ_SINGLE_REGISTER_VALUES:
-                    _communicationReadSingleRegisterValueHandler(data_payload);
-                    break;
+// -----------------------------------------------------------------------------
 
-                case COMMUNICATION_PACKET_READ_MULTIPLE_REGISTERS_VALUES:
-                    _communicationReadMultipleRegistersValuesHandler(data_payload);
-                    break;
-            #endif
+/**
+ * Unacknowledged report registers are returned back to outbox, so they are retried with
+ * their latest values coalesced with newer changes. Retries are spaced with exponential backoff
+ */
+void _communicationReportInflightHandle()
+{
+    if (
+        _communicationReportIsInflight() == false
+        || (millis() - _communication_report_sent) < _communication_report_backoff
+    ) {
+        return;
+    }
 
-            #if REGISTER_MAX_INPUT_REGISTERS_SIZE || REGISTER_MAX_OUTPUT_REGISTERS_SIZE || REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
-                case COMMUNICATION_PACKET_READ_SINGLE_REGISTER_STRUCTURE:
-                    _communicationReadSingleRegisterStructureHandler(data_payload, data_length, false);
-                    break;
-            #endif
+    if (_communication_report_retries >= COMMUNICATION_REPORT_MAX_RETRIES) {
+        #if DEBUG_COMMUNICATION_SUPPORT
+            DLOG(LOG_COMMUNICATION_REPORT_DROPPED, _communication_report_sequence);
+        #endif
 
-            #if REGISTER_MAX_OUTPUT_REGISTERS_SIZE || REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
-                case COMMUNICATION_PACKET_WRITE_SINGLE_REGISTER_VALUE:
-                    _communicationWriteSingleRegisterValueHandler(data_payload);
-                    break;
-        
-                case COMMUNICATION_PACKET_WRITE_MULTIPLE_REGISTERS_VALUES:
-                    _communicationWriteMultipleRegistersValuesHandler(data_payload);
-                    break;
-            #endif
+        // Master will have to read registers when it is back
+        _communication_master_lost = true;
 
-            /**
-             * OTHER
-             */
+        _communication_report_retries = 0;
+        _communication_report_backoff = COMMUNICATION_REPORT_ACK_TIMEOUT;
 
-            default:
-                _communicationReplyWithException(data_payload);
+        memset(_communication_report_inflight, 0, COMMUNICATION_REPORT_OUTBOX_SIZE);
 
-        }
+        return;
     }
 
     #if DEBUG_COMMUNICATION_SUPPORT
-        DPRINTLN(F("[COMMUNICATION] ================================="));
-        DPRINTLN(F("[COMMUNICATION] Handling received packet finished"));
-        DPRINTLN(F("[COMMUNICATION] ================================="));
-        DPRINTLN();
+        DLOG(LOG_COMMUNICATION_REPORT_RETRY, _communication_report_sequence);
     #endif
+
+    for (uint8_t i = 0; i < COMMUNICATION_REPORT_OUTBOX_SIZE; i++) {
+        _communication_report_outbox[i] |= _communication_report_inflight[i];
+        _communication_report_inflight[i] = 0;
+    }
+
+    _communication_report_retries++;
+    _communication_report_backoff = _communication_report_backoff * 2;
+
+    if (_communication_report_backoff > COMMUNICATION_REPORT_BACKOFF_MAX) {
+        _communication_report_backoff = COMMUNICATION_REPORT_BACKOFF_MAX;
+    }
 }
 
 // -----------------------------------------------------------------------------
 
-void _communicationErrorHandler(
-    const uint8_t code,
-    const uint16_t data,
-    void * customPointer
+/**
+ * Parse received payload - Master acknowledged report
+ *
+ * 0 => Received packet identifier  => COMMUNICATION_PACKET_REPORT_ACKNOWLEDGE
+ * 1 => Acknowledged report sequence number
+ */
+void _communicationReportAcknowledgeHandler(
+    uint8_t * payload,
+    const uint16_t length,
+    const bool isBroadcast
 ) {
-    #if DEBUG_COMMUNICATION_SUPPORT
-        if (code == PJON_CONNECTION_LOST) {
-            _communication_master_lost = true;
-
-            DPRINTLN(F("[COMMUNICATION][ERR] Connection lost with master"));
+    // Acknowledge of already retried report is ignored, retried report is waiting for its own
+    if ((uint8_t) payload[1] != _communication_report_sequence) {
+        #if DEBUG_COMMUNICATION_SUPPORT
+            DLOG(LOG_COMMUNICATION_REPORT_UNEXPECTED_ACK, payload[1]);
+        #endif
 
-        } else if (code == PJON_PACKETS_BUFFER_FULL) {
-            DPRINTLN(F("[COMMUNICATION][ERR] Buffer is full"));
+        return;
+    }
 
-        } else if (code == PJON_CONTENT_TOO_LONG) {
-            DPRINTLN(F("[COMMUNICATION][ERR] Content is long"));
+    memset(_communication_report_inflight, 0, COMMUNICATION_REPORT_OUTBOX_SIZE);
 
-        } else {
-            DPRINTLN(F("[COMMUNICATION][ERR] Unknown error"));
-        }
-    #endif
+    _communication_report_retries = 0;
+    _communication_report_backoff = COMMUNICATION_REPORT_ACK_TIMEOUT;
 }
+
 // -----------------------------------------------------------------------------
 
-uint16_t _communicationFinalizeAndSendPacket(
-    const char * payload,
-    const uint8_t length,
-    const uint8_t address,
-    const bool isReply
+bool _communicationReportSingleRegister(
+    const uint8_t registerType,
+    const uint8_t registerAddress
 ) {
-    uint16_t final_length = length + 2;
-
-    char final_payload[final_length];
-
-    // Add protocol version
-    final_payload[0] = COMMUNICATION_PROTOCOL_VERSION;
-
-    uint8_t byte_position = 1;
+    uint8_t register_value[4] = { 0, 0, 0, 0 };
 
-    for (uint8_t i = 0; i < length; i++){
-        final_payload[byte_position] = payload[i];
+    if (registerReadRegister(registerType, registerAddress, register_value) == false) {
+        return false;
+    }
 
-        byte_position++;
+    // 0    => Packet identifier
+    // 1    => Report sequence number
+    // 2    => Register type
+    // 3    => High byte of register address
+    // 4    => Low byte of register address
+    // 5-8  => Register value
+    _communication_output_buffer[0] = (char) COMMUNICATION_PACKET_REPORT_SINGLE_REGISTER_VALUE;
+    _communication_output_buffer[1] = (char) _communicationReportNextSequence();
+    _communication_output_buffer[2] = (char) registerType;
+    _communication_output_buffer[3] = (char) (registerAddress >> 8);
+    _communication_output_buffer[4] = (char) (registerAddress & 0xFF);
+    _communication_output_buffer[5] = (char) register_value[0];
+    _communication_output_buffer[6] = (char) register_value[1];
+    _communication_output_buffer[7] = (char) register_value[2];
+    _communication_output_buffer[8] = (char) register_value[3];
+
+    if (_communicationSendPacket(COMMUNICATION_BUS_MASTER_ADDR, _communication_output_buffer, 9) == false) {
+        return false;
     }
 
-    // Be sure to set the null terminator!!!
-    final_payload[byte_position] = COMMUNICATION_PACKET_TERMINATOR;
+    #if DEBUG_COMMUNICATION_SUPPORT
+        DLOG(LOG_COMMUNICATION_REPORT_SINGLE_SENT);
+    #endif
 
-    if (isReply) {
-        return _communication_bus.reply(
-            final_payload,      // Content
-            final_length        // Content length
-        );
+    _communicationReportSent();
 
-    } else {
-        return _communication_bus.send_packet(
-            address,            // Recepient address
-            final_payload,      // Content
-            final_length        // Content length
-        );
-    }
+    _communicationReportOutboxMark(registerType, registerAddress, false);
+    _communicationReportInflightMark(registerType, registerAddress);
+    _communicationSubscriptionReported(registerType, registerAddress);
+
+    return true;
 }
 
 // -----------------------------------------------------------------------------
 
-uint16_t _communicationFinalizeAndSendPacket(
-    const char * payload,
-    const uint8_t length,
-    const uint8_t address
+/**
+ * Report all changed registers of given type which fit into one packet
+ *
+ * 0        => Packet identifier
+ * 1        => Report sequence number
+ * 2        => Register type
+ * 3        => Count of registers
+ * 4        => High byte of first register address
+ * 5        => Low byte of first register address
+ * 6-n      => First register value in its data type size
+ * n+1-m    => Next registers addresses & values
+ */
+bool _communicationReportMultipleRegisters(
+    const uint8_t registerType
 ) {
-    return _communicationFinalizeAndSendPacket(payload, length, address, false);
-}
+    _communication_output_buffer[0] = (char) COMMUNICATION_PACKET_REPORT_MULTIPLE_REGISTERS_VALUES;
+    _communication_output_buffer[1] = (char) _communicationReportNextSequence();
+    _communication_output_buffer[2] = (char) registerType;
+    _communication_output_buffer[3] = (char) 0; // Temporary value, will be updated after collecting all
 
-// -----------------------------------------------------------------------------
+    uint8_t byte_pointer = 4;
+    uint8_t registers_counter = 0;
 
-uint16_t _communicationFinalizeAndSendPacket(
-    const char * payload,
-    const uint8_t length,
-    const bool isReply
-) {
-    return _communicationFinalizeAndSendPacket(payload, length, 0, isReply);
-}
+    uint8_t register_value[4] = { 0, 0, 0, 0 };
 
-// -----------------------------------------------------------------------------
+    for (uint8_t i = 0; i < registerGetRegistersSize(registerType); i++) {
+        if (
+            _communicationReportOutboxIsMarked(registerType, i) == false
+            || _communicationSubscriptionIsDue(registerType, i) == false
+        ) {
+            continue;
+        }
 
-bool _communicationSendPacket(
-    const uint8_t address,
-    const char * payload,
-    const uint8_t length
-) {
-    uint16_t result = _communicationFinalizeAndSendPacket(payload, length, address);
+        uint8_t data_type_size = registerGetDataTypeSize(registerGetRegisterDataType(registerType, i));
 
-    if (result != PJON_ACK) {
-        if (result == PJON_BUSY ) {
-            #if DEBUG_COMMUNICATION_SUPPORT
-                DPRINT(F("[COMMUNICATION][ERR] Sending packet to address: "));
-                DPRINT(address);
-                DPRINT(F(" failed, bus is busy, packet: "));
-                DPRINTLN((uint8_t) payload[0]);
-            #endif
+        if (data_type_size == 0 || registerReadRegister(registerType, i, register_value) == false) {
+            // Value could not be transferred, drop it from outbox
+            _communicationReportOutboxMark(registerType, i, false);
 
-        } else if (result == PJON_FAIL) {
-            #if DEBUG_COMMUNICATION_SUPPORT
-                DPRINT(F("[COMMUNICATION][ERR] Sending packet to address: "));
-                DPRINT(address);
-                DPRINT(F(" failed, packet: "));
-                DPRINTLN((uint8_t) payload[0]);
-            #endif
+            continue;
+        }
 
-        } else {
-            #if DEBUG_COMMUNICATION_SUPPORT
-                DPRINT(F("[COMMUNICATION][ERR] Sending packet to address: "));
-                DPRINT(address);
-                DPRINT(F(" failed, unknonw error, packet: "));
-                DPRINTLN((uint8_t) payload[0]);
-            #endif
+        // Rest of changed registers will be sent in next packet
+        if ((byte_pointer + 2 + data_type_size) > (PJON_PACKET_MAX_LENGTH - COMMUNICATION_PACKET_OVERHEAD)) {
+            break;
         }
 
-        return false;
-    }
+        _communication_output_buffer[byte_pointer] = (char) (i >> 8);
+        _communication_output_buffer[byte_pointer + 1] = (char) (i & 0xFF);
 
-    if (address == PJON_BROADCAST) {
-        #if DEBUG_COMMUNICATION_SUPPORT
-            DPRINT(F("[COMMUNICATION] Successfully sent broadcast packet "));
-            DPRINTLN((uint8_t) payload[0]);
-        #endif
+        memcpy(&_communication_output_buffer[byte_pointer + 2], register_value, data_type_size);
 
-    } else {
-        #if DEBUG_COMMUNICATION_SUPPORT
-            DPRINT(F("[COMMUNICATION] Successfully sent packet: "));
-            DPRINT((uint8_t) payload[0]);
-            DPRINT(F(" to address: "));
-            DPRINTLN(address);
-        #endif
+        byte_pointer = byte_pointer + 2 + data_type_size;
+
+        registers_counter++;
     }
 
-    return true;
-}
+    if (registers_counter == 0) {
+        return true;
+    }
 
-// -----------------------------------------------------------------------------
+    // Update registers count
+    _communication_output_buffer[3] = (char) registers_counter;
+
+    if (_communicationSendPacket(COMMUNICATION_BUS_MASTER_ADDR, _communication_output_buffer, byte_pointer) == false) {
+        return false;
+    }
 
-bool _communicationReplyToPacket(
-    char * payload,
-    const uint8_t length
-) {
     #if DEBUG_COMMUNICATION_SUPPORT
-        DPRINT(F("[COMMUNICATION] Preparing reply packet: "));
-        DPRINTLN((uint8_t) payload[0]);
+        DLOG(LOG_COMMUNICATION_REPORT_MULTIPLE_SENT, registers_counter);
     #endif
 
-    uint16_t result =_communicationFinalizeAndSendPacket(payload, length, true);
+    _communicationReportSent();
 
-    if (result == PJON_FAIL) {
-        #if DEBUG_COMMUNICATION_SUPPORT
-            DPRINTLN(F("[COMMUNICATION] Sending replypacket failed"));
-        #endif
+    // Move sent registers from outbox to acknowledge waiting
+    uint8_t sent_pointer = 4;
 
-        return false;
+    for (uint8_t i = 0; i < registers_counter; i++) {
+        uint8_t register_address = (uint8_t) _communication_output_buffer[sent_pointer + 1];
+
+        _communicationReportOutboxMark(registerType, register_address, false);
+        _communicationReportInflightMark(registerType, register_address);
+        _communicationSubscriptionReported(registerType, register_address);
+
+        sent_pointer = sent_pointer + 2 + registerGetDataTypeSize(registerGetRegisterDataType(registerType, register_address));
     }
 
     return true;
@@ -1501,28 +2959,60 @@ bool _communicationReplyToPacket(
 
 // -----------------------------------------------------------------------------
 
-bool _communicationBroadcastPacket(
-    char * payload,
-    const uint8_t length
-) {
-    #if DEBUG_COMMUNICATION_SUPPORT
-        DPRINT(F("[COMMUNICATION] Preparing broadcast packet: "));
-        DPRINTLN((uint8_t) payload[0]);
-    #endif
+/**
+ * Send one report packet with changed registers, only one packet is sent per loop
+ * so the bus is not blocked with a burst of reports. Next report is sent after previous
+ * one is acknowledged by master
+ */
+void _communicationReportOutboxFlush()
+{
+    if (_communicationReportIsInflight()) {
+        return;
+    }
 
-    uint8_t address = PJON_BROADCAST;
+    bool is_empty = true;
 
-    uint16_t result = _communicationFinalizeAndSendPacket(payload, length, address);
+    for (uint8_t i = 0; i < COMMUNICATION_REPORT_OUTBOX_SIZE; i++) {
+        if (_communication_report_outbox[i] != 0) {
+            is_empty = false;
 
-    if (result == PJON_FAIL) {
-        #if DEBUG_COMMUNICATION_SUPPORT
-            DPRINTLN(F("[COMMUNICATION] Sending broadcast failed"));
-        #endif
+            break;
+        }
+    }
 
-        return false;
+    if (is_empty) {
+        return;
     }
 
-    return true;
+    uint8_t registers_types[3] = { REGISTER_TYPE_INPUT, REGISTER_TYPE_OUTPUT, REGISTER_TYPE_ATTRIBUTE };
+
+    for (uint8_t type = 0; type < 3; type++) {
+        uint8_t marked_counter = 0;
+        uint8_t marked_address = 0;
+
+        for (uint8_t i = 0; i < registerGetRegistersSize(registers_types[type]); i++) {
+            if (
+                _communicationReportOutboxIsMarked(registers_types[type], i)
+                && _communicationSubscriptionIsDue(registers_types[type], i)
+            ) {
+                marked_address = i;
+                marked_counter++;
+            }
+        }
+
+        if (marked_counter == 0) {
+            continue;
+        }
+
+        if (marked_counter == 1) {
+            _communicationReportSingleRegister(registers_types[type], marked_address);
+
+        } else {
+            _communicationReportMultipleRegisters(registers_types[type]);
+        }
+
+        return;
+    }
 }
 
 // -----------------------------------------------------------------------------
@@ -1551,17 +3041,53 @@ void communicationSetAddress(
 
 // -----------------------------------------------------------------------------
 
+/**
+ * Handle frame waiting in bus receive buffer, main loop is calling it between lower priority modules loops
+ */
+void communicationReceive()
+{
+    _communication_bus.receive();
+}
+
+// -----------------------------------------------------------------------------
+
 bool communicationIsMasterLost()
 {
     return ((millis() - _communication_master_last_request) > COMMUNICATION_MASTER_PING_TIMEOUT || _communication_master_lost);
 }
 
+// -----------------------------------------------------------------------------
+
+#if COMMUNICATION_CAPTURE_SUPPORT
+/**
+ * Has to be called in main loop idle time, captured frames are sent while they fit into serial transmit buffer
+ *
+ * @return False when capture line was not finished, nothing else could be written to serial port
+ */
+bool communicationCaptureLoop()
+{
+    return _communicationCaptureWrite(false);
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Send all captured frames, could be used only where blocking is acceptable (boot, restart)
+ */
+void communicationCaptureFlush()
+{
+    _communicationCaptureWrite(true);
+}
+#endif
+
+
 // -----------------------------------------------------------------------------
 // REGISTERS
 // -----------------------------------------------------------------------------
 
 /**
- * Report value of register to master
+ * Schedule report of register value to master, reports are sent from communication loop
+ * and repeated changes of one register are sent only with its latest value
  */
 bool communicationReportRegister(
     const uint8_t registerType,
@@ -1571,37 +3097,34 @@ bool communicationReportRegister(
         return false;
     }
 
-    uint8_t register_value[4] = { 0, 0, 0, 0 };
-    
-    if (registerReadRegister(registerType, registerAddress, register_value) == false) {
+    if (_communicationReportOutboxIndex(registerType, registerAddress) < 0) {
         return false;
     }
 
-    memset(_communication_output_buffer, 0, PJON_PACKET_MAX_LENGTH);
+    // Change of subscribed register is under deadband
+    if (_communicationSubscriptionIsSignificant(registerType, registerAddress) == false) {
+        return true;
+    }
 
-    // 0    => Packet identifier
-    // 1    => Register type
-    // 2    => High byte of register address
-    // 3    => Low byte of register address
-    // 4-7  => Register value
-    _communication_output_buffer[0] = (char) COMMUNICATION_PACKET_REPORT_SINGLE_REGISTER_VALUE;
-    _communication_output_buffer[1] = (char) registerType;
-    _communication_output_buffer[2] = (char) (registerAddress >> 8);
-    _communication_output_buffer[3] = (char) (registerAddress & 0xFF);
-    _communication_output_buffer[4] = (char) register_value[0];
-    _communication_output_buffer[5] = (char) register_value[1];
-    _communication_output_buffer[6] = (char) register_value[2];
-    _communication_output_buffer[7] = (char) register_value[3];
+    _communicationReportOutboxMark(registerType, registerAddress, true);
 
-    if (_communicationSendPacket(COMMUNICATION_BUS_MASTER_ADDR, _communication_output_buffer, 8) == true) {
-        #if DEBUG_COMMUNICATION_SUPPORT
-            DPRINTLN(F("[COMMUNICATION] Register value was successfully sent"));
-        #endif
+    return true;
+}
 
-        return true;
+// -----------------------------------------------------------------------------
+
+/**
+ * Schedule report of frequently refreshed register, it is reported only when master subscribed it
+ */
+bool communicationReportSubscribedRegister(
+    const uint8_t registerType,
+    const uint8_t registerAddress
+) {
+    if (_communicationSubscriptionIndex(registerType, registerAddress) == INDEX_NONE) {
+        return false;
     }
 
-    return false;
+    return communicationReportRegister(registerType, registerAddress);
 }
 
 // -----------------------------------------------------------------------------
@@ -1640,9 +3163,7 @@ void communicationSetup()
 
     if (device_address != PJON_NOT_ASSIGNED && (device_address == 0 || device_address >= 250)) {
         #if DEBUG_COMMUNICATION_SUPPORT
-            DPRINT(F("[COMMUNICATION] Stored address: "));
-            DPRINT(device_address);
-            DPRINTLN(F(" is invalid, reseting to unassigned address"));
+            DLOG(LOG_COMMUNICATION_STORED_ADDRESS_INVALID, device_address);
         #endif
 
         registerWriteRegister(REGISTER_TYPE_ATTRIBUTE, COMMUNICATION_ATTR_REGISTER_ADDR_ADDRESS, PJON_NOT_ASSIGNED, false);
@@ -1652,17 +3173,26 @@ void communicationSetup()
 
     #if DEBUG_COMMUNICATION_SUPPORT
         if (device_address == PJON_NOT_ASSIGNED) {
-            DPRINTLN(F("[COMMUNICATION] Unaddressed device"));
+            DLOG(LOG_COMMUNICATION_UNADDRESSED);
 
         } else {
-            DPRINT(F("[COMMUNICATION] Stored device address: "));
-            DPRINTLN(device_address);
+            DLOG(LOG_COMMUNICATION_STORED_ADDRESS, device_address);
         }
     #endif
 
     if (device_address != PJON_NOT_ASSIGNED) {
         _communication_bus.set_id(device_address);
     }
+
+    #if COMMUNICATION_BAUDRATE_SUPPORT
+        // Device is always starting with default baudrate
+        registerWriteRegister(REGISTER_TYPE_ATTRIBUTE, COMMUNICATION_ATTR_REGISTER_MAX_BAUDRATE_ADDRESS, (uint32_t) COMMUNICATION_SERIAL_MAX_BAUDRATE, false);
+        registerWriteRegister(REGISTER_TYPE_ATTRIBUTE, COMMUNICATION_ATTR_REGISTER_BAUDRATE_ADDRESS, (uint32_t) COMMUNICATION_SERIAL_BAUDRATE, false);
+
+        registerAddObserver(REGISTER_TYPE_ATTRIBUTE, COMMUNICATION_ATTR_REGISTER_BAUDRATE_ADDRESS, 1, _communicationBaudrateChanged, false);
+    #endif
+
+    registerAddObserver(REGISTER_TYPE_ATTRIBUTE, COMMUNICATION_ATTR_REGISTER_ADDR_ADDRESS, 1, _communicationAddressChanged, false);
 }
 
 // -----------------------------------------------------------------------------
@@ -1686,4 +3216,30 @@ void communicationLoop()
     // -------------------------------------------------------------------------
     _communication_bus.update();
     _communication_bus.receive();
+
+    // -------------------------------------------------------------------------
+    // Slotted discovery
+    // -------------------------------------------------------------------------
+    _communicationDiscoverSlotHandle();
+
+    #if COMMUNICATION_BAUDRATE_SUPPORT
+        // -------------------------------------------------------------------------
+        // Bus baudrate
+        // -------------------------------------------------------------------------
+        _communicationBaudrateHandle();
+    #endif
+
+    // -------------------------------------------------------------------------
+    // Registers reporting
+    // -------------------------------------------------------------------------
+    if (firmwareIsRunning()) {
+        _communicationSubscriptionsHeartbeat();
+        _communicationReportInflightHandle();
+        _communicationReportOutboxFlush();
+
+    } else {
+        // Changes are not reported when device is not running
+        memset(_communication_report_outbox, 0, COMMUNICATION_REPORT_OUTBOX_SIZE);
+        memset(_communication_report_inflight, 0, COMMUNICATION_REPORT_OUTBOX_SIZE);
+    }
 }
@@ -13,14 +13,15 @@ Copyright (C) 2018 FastyBird s.r.o. <code@fastybird.com>
 
     #include "firmware.h"
     #include "types.h"
+    #include "log.h"
     #include "prototypes.h"
     #include "hardware.h"
     #include "general.h"
+    #include "device.h"
     #include "dependencies.h"
 
     #if DEBUG_SUPPORT
-        #define DPRINTLN(x) Serial.println(x)
-        #define DPRINT(x) Serial.print(x)
+        #define DLOG(...) logWrite(__VA_ARGS__)
     #endif
 
     // =============================================================================
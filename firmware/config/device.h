@@ -0,0 +1,276 @@
+/*
+
+DEVICE DESCRIPTOR TABLES
+
+Copyright (C) 2022 FastyBird s.r.o. <code@fastybird.com>
+
+*/
+
+#pragma once
+
+//------------------------------------------------------------------------------
+// Do not change this file unless you know what you are doing
+// Board channels are declared once in the hardware.h file, modules tables and
+// communication registers are generated here during compilation
+//------------------------------------------------------------------------------
+
+// =============================================================================
+// GENERATOR HELPERS
+// =============================================================================
+
+template<uint8_t... I> struct device_indexes_t {};
+
+template<uint8_t N, uint8_t... I> struct device_make_indexes_t : device_make_indexes_t<N - 1, N - 1, I...> {};
+
+template<uint8_t... I> struct device_make_indexes_t<0, I...> {
+    typedef device_indexes_t<I...> type;
+};
+
+// Arrays could not be returned from function, generated table is wrapped
+template<typename T, uint8_t N> struct device_table_t {
+    T items[N];
+};
+
+// =============================================================================
+// REGISTERS DATA TYPES
+// =============================================================================
+
+// Count of bytes used by data type value when transferred, indexed by data type
+constexpr uint8_t device_data_type_sizes[] = {
+    0,  // Not used
+    1,  // REGISTER_DATA_TYPE_UINT8
+    2,  // REGISTER_DATA_TYPE_UINT16
+    4,  // REGISTER_DATA_TYPE_UINT32
+    1,  // REGISTER_DATA_TYPE_INT8
+    2,  // REGISTER_DATA_TYPE_INT16
+    4,  // REGISTER_DATA_TYPE_INT32
+    4,  // REGISTER_DATA_TYPE_FLOAT32
+    2,  // REGISTER_DATA_TYPE_BOOLEAN
+    0,  // REGISTER_DATA_TYPE_TIME
+    0,  // REGISTER_DATA_TYPE_DATE
+    0,  // REGISTER_DATA_TYPE_DATETIME
+    0,  // REGISTER_DATA_TYPE_STRING
+    1,  // REGISTER_DATA_TYPE_BUTTON
+    1,  // REGISTER_DATA_TYPE_SWITCH
+};
+
+static_assert(sizeof(device_data_type_sizes) == REGISTER_DATA_TYPE_SWITCH + 1, "Data types sizes table does not cover all data types");
+
+constexpr uint8_t deviceDataTypeSize(
+    const uint8_t dataType
+) {
+    return dataType < sizeof(device_data_type_sizes) ? device_data_type_sizes[dataType] : 0;
+}
+
+// =============================================================================
+// BUTTONS
+// =============================================================================
+
+#if BUTTON_MAX_ITEMS
+    static_assert(sizeof(device_buttons) / sizeof(device_buttons[0]) == BUTTON_MAX_ITEMS, "BUTTON_MAX_ITEMS does not match count of declared buttons");
+
+    /**
+     * Input registers are assigned to buttons in declaration order
+     */
+    constexpr uint8_t deviceButtonRegistersBefore(
+        const uint8_t index
+    ) {
+        return index == 0 ? 0 : deviceButtonRegistersBefore(index - 1) + (device_buttons[index - 1].input_register ? 1 : 0);
+    }
+
+    constexpr button_t deviceButtonItem(
+        const uint8_t index
+    ) {
+        return {
+            device_buttons[index].pin,
+            device_buttons[index].input_register ? deviceButtonRegistersBefore(index) : (uint8_t) INDEX_NONE,
+            BUTTON_EVENT_NONE
+        };
+    }
+
+    template<uint8_t... I>
+    constexpr device_table_t<button_t, sizeof...(I)> deviceButtonItems(device_indexes_t<I...>) {
+        return {{deviceButtonItem(I)...}};
+    }
+
+    device_table_t<button_t, BUTTON_MAX_ITEMS> _device_button_items = deviceButtonItems(device_make_indexes_t<BUTTON_MAX_ITEMS>::type());
+
+    static constexpr button_t (& button_module_items)[BUTTON_MAX_ITEMS] = _device_button_items.items;
+
+    #define DEVICE_BUTTON_REGISTERS_SIZE            deviceButtonRegistersBefore(BUTTON_MAX_ITEMS)
+#else
+    button_t button_module_items[BUTTON_MAX_ITEMS];
+
+    #define DEVICE_BUTTON_REGISTERS_SIZE            0
+#endif
+
+// Expander inputs are following buttons in input registers
+constexpr uint8_t deviceExpanderRegisterAddress(
+    const uint8_t index
+) {
+    return DEVICE_BUTTON_REGISTERS_SIZE + index;
+}
+
+// =============================================================================
+// RELAYS
+// =============================================================================
+
+#if RELAY_MAX_ITEMS
+    static_assert(sizeof(device_relays) / sizeof(device_relays[0]) == RELAY_MAX_ITEMS, "RELAY_MAX_ITEMS does not match count of declared relays");
+    static_assert(FLASH_ADDRESS_RELAY_01 + RELAY_MAX_ITEMS <= FLASH_ADDRESSES_SIZE, "Relays states do not fit into flash addresses");
+
+    constexpr relay_t deviceRelayItem(
+        const uint8_t index
+    ) {
+        return {
+            device_relays[index].pin,
+            device_relays[index].type,
+            device_relays[index].reset_pin,
+            index,
+            RELAY_DELAY_ON,
+            RELAY_DELAY_OFF,
+            false,
+            false,
+            0,
+            0,
+            0
+        };
+    }
+
+    template<uint8_t... I>
+    constexpr device_table_t<relay_t, sizeof...(I)> deviceRelayItems(device_indexes_t<I...>) {
+        return {{deviceRelayItem(I)...}};
+    }
+
+    device_table_t<relay_t, RELAY_MAX_ITEMS> _device_relay_items = deviceRelayItems(device_make_indexes_t<RELAY_MAX_ITEMS>::type());
+
+    static constexpr relay_t (& relay_module_items)[RELAY_MAX_ITEMS] = _device_relay_items.items;
+#endif
+
+// =============================================================================
+// REGISTERS
+// =============================================================================
+
+static_assert(
+    REGISTER_MAX_INPUT_REGISTERS_SIZE == DEVICE_BUTTON_REGISTERS_SIZE + (BUTTON_EXPANDER_SUPPORT ? BUTTON_EXPANDER_INPUTS : 0),
+    "REGISTER_MAX_INPUT_REGISTERS_SIZE does not match count of buttons with input register"
+);
+static_assert(REGISTER_MAX_OUTPUT_REGISTERS_SIZE == RELAY_MAX_ITEMS, "REGISTER_MAX_OUTPUT_REGISTERS_SIZE does not match count of relays");
+
+#define DEVICE_REGISTERS_SIZE                       (REGISTER_MAX_INPUT_REGISTERS_SIZE + REGISTER_MAX_OUTPUT_REGISTERS_SIZE + REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE)
+
+static_assert(DEVICE_REGISTERS_SIZE < INDEX_NONE, "Too many registers");
+
+#if REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
+    static_assert(
+        sizeof(register_module_attribute_registers) / sizeof(register_module_attribute_registers[0]) == REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE,
+        "REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE does not match count of declared attributes"
+    );
+
+    constexpr uint8_t deviceAttributeDataType(
+        const uint8_t address
+    ) {
+        return register_module_attribute_registers[address].data_type;
+    }
+
+    constexpr uint8_t deviceAttributeFlashAddress(
+        const uint8_t address
+    ) {
+        return register_module_attribute_registers[address].flash_address;
+    }
+#else
+    constexpr uint8_t deviceAttributeDataType(
+        const uint8_t address
+    ) {
+        return REGISTER_DATA_TYPE_UNKNOWN;
+    }
+
+    constexpr uint8_t deviceAttributeFlashAddress(
+        const uint8_t address
+    ) {
+        return INDEX_NONE;
+    }
+#endif
+
+/**
+ * Registers of all types are indexed in one block: inputs, outputs & attributes
+ * Inputs are holding buttons events, outputs relays states and each relay state is persisted
+ */
+constexpr uint8_t deviceRegisterDataType(
+    const uint8_t index
+) {
+    return index < REGISTER_MAX_INPUT_REGISTERS_SIZE ? REGISTER_DATA_TYPE_BUTTON : (
+        index < REGISTER_MAX_INPUT_REGISTERS_SIZE + REGISTER_MAX_OUTPUT_REGISTERS_SIZE ? REGISTER_DATA_TYPE_SWITCH :
+        deviceAttributeDataType(index - REGISTER_MAX_INPUT_REGISTERS_SIZE - REGISTER_MAX_OUTPUT_REGISTERS_SIZE)
+    );
+}
+
+constexpr uint8_t deviceRegisterFlashAddress(
+    const uint8_t index
+) {
+    return index < REGISTER_MAX_INPUT_REGISTERS_SIZE ? (uint8_t) INDEX_NONE : (
+        index < REGISTER_MAX_INPUT_REGISTERS_SIZE + REGISTER_MAX_OUTPUT_REGISTERS_SIZE ? (uint8_t) (FLASH_ADDRESS_RELAY_01 + index - REGISTER_MAX_INPUT_REGISTERS_SIZE) :
+        deviceAttributeFlashAddress(index - REGISTER_MAX_INPUT_REGISTERS_SIZE - REGISTER_MAX_OUTPUT_REGISTERS_SIZE)
+    );
+}
+
+#if COMMUNICATION_BAUDRATE_SUPPORT
+    static_assert(
+        COMMUNICATION_ATTR_REGISTER_MAX_BAUDRATE_ADDRESS < REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
+        && COMMUNICATION_ATTR_REGISTER_BAUDRATE_ADDRESS < REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
+        && deviceAttributeDataType(COMMUNICATION_ATTR_REGISTER_MAX_BAUDRATE_ADDRESS) == REGISTER_DATA_TYPE_UINT32
+        && deviceAttributeDataType(COMMUNICATION_ATTR_REGISTER_BAUDRATE_ADDRESS) == REGISTER_DATA_TYPE_UINT32,
+        "Baudrate attribute registers have to be declared as UINT32 registers"
+    );
+
+    // NeoSWSerial is supporting 9600, 19200, 31250 & 38400 only
+    static_assert(COMMUNICATION_BUS_HARDWARE_SERIAL || COMMUNICATION_SERIAL_MAX_BAUDRATE <= 38400, "Software serial bus could not run faster than 38400");
+#endif
+
+#if STATS_SUPPORT
+    constexpr bool deviceStatsRegistersDeclared(
+        const uint8_t index
+    ) {
+        return index == STATS_REGISTERS_SIZE ? true : (
+            deviceAttributeDataType(STATS_ATTR_REGISTER_START + index) == REGISTER_DATA_TYPE_UINT32
+            && deviceAttributeFlashAddress(STATS_ATTR_REGISTER_START + index) == INDEX_NONE
+            && deviceStatsRegistersDeclared(index + 1)
+        );
+    }
+
+    static_assert(STATS_ATTR_REGISTER_START + STATS_REGISTERS_SIZE <= REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE, "Stats attribute registers are not declared");
+    static_assert(deviceStatsRegistersDeclared(0), "Stats attribute registers have to be not stored UINT32 registers");
+#endif
+
+#if RELAY_SCENES_SUPPORT
+    constexpr bool deviceSceneRegistersDeclared(
+        const uint8_t index
+    ) {
+        return index == RELAY_SCENES_SIZE ? true : (
+            deviceAttributeDataType(RELAY_SCENES_ATTR_REGISTER_START + index) == REGISTER_DATA_TYPE_UINT32
+            && deviceAttributeFlashAddress(RELAY_SCENES_ATTR_REGISTER_START + index) == FLASH_ADDRESS_SCENE_01 + index
+            && deviceSceneRegistersDeclared(index + 1)
+        );
+    }
+
+    // Scene is holding mask & states of output registers in one UINT32 register
+    static_assert(REGISTER_MAX_OUTPUT_REGISTERS_SIZE <= 16, "Scene could address up to 16 output registers");
+    static_assert(RELAY_SCENES_SIZE <= 8, "Only 8 scenes have reserved flash address");
+    static_assert(FLASH_ADDRESS_SCENE_01 + RELAY_SCENES_SIZE + 3 <= FLASH_ADDRESS_RELAY_01, "Scenes flash addresses are overlapping relays states");
+    static_assert(RELAY_SCENES_ATTR_REGISTER_START + RELAY_SCENES_SIZE <= REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE, "Scene attribute registers are not declared");
+    static_assert(deviceSceneRegistersDeclared(0), "Scene attribute registers have to be stored UINT32 registers");
+#endif
+
+template<uint8_t... I>
+constexpr device_table_t<uint8_t, sizeof...(I)> deviceRegistersDataTypes(device_indexes_t<I...>) {
+    return {{deviceRegisterDataType(I)...}};
+}
+
+template<uint8_t... I>
+constexpr device_table_t<uint8_t, sizeof...(I)> deviceRegistersFlashAddresses(device_indexes_t<I...>) {
+    return {{deviceRegisterFlashAddress(I)...}};
+}
+
+// Registers metadata are not changing, so they are kept in flash
+const device_table_t<uint8_t, DEVICE_REGISTERS_SIZE> device_registers_data_types PROGMEM = deviceRegistersDataTypes(device_make_indexes_t<DEVICE_REGISTERS_SIZE>::type());
+const device_table_t<uint8_t, DEVICE_REGISTERS_SIZE> device_registers_flash_addresses PROGMEM = deviceRegistersFlashAddresses(device_make_indexes_t<DEVICE_REGISTERS_SIZE>::type());
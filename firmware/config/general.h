@@ -18,9 +18,8 @@ Copyright (C) 2018 FastyBird s.r.o. <code@fastybird.com>
 #define DEBUG_COMMUNICATION_SUPPORT                 1               // Enable communication serial debug log
 #endif
 
-#ifndef DEBUG_ADD_TIMESTAMP
-#define DEBUG_ADD_TIMESTAMP                         1               // Add timestamp to debug messages
-                                                                    // (in millis overflowing every 1000 seconds)
+#ifndef LOG_BUFFER_SIZE
+#define LOG_BUFFER_SIZE                             128             // RAM ring for binary log records waiting for serial line
 #endif
 
 // =============================================================================
@@ -45,6 +44,40 @@ Copyright (C) 2018 FastyBird s.r.o. <code@fastybird.com>
 #define SYSTEM_RESTART_DELAY                        1000
 #endif
 
+// Modules loops periods in ms, 0 means every main loop
+#ifndef SYSTEM_COMMUNICATION_TASK_PERIOD
+#define SYSTEM_COMMUNICATION_TASK_PERIOD            0
+#endif
+
+#ifndef SYSTEM_BUTTON_TASK_PERIOD
+#define SYSTEM_BUTTON_TASK_PERIOD                   2
+#endif
+
+#ifndef SYSTEM_RELAY_TASK_PERIOD
+#define SYSTEM_RELAY_TASK_PERIOD                    5
+#endif
+
+#ifndef SYSTEM_LED_TASK_PERIOD
+#define SYSTEM_LED_TASK_PERIOD                      20
+#endif
+
+// Modules loops time budgets in us, longer runs are counted as overruns
+#ifndef SYSTEM_COMMUNICATION_TASK_BUDGET
+#define SYSTEM_COMMUNICATION_TASK_BUDGET            10000           // Reply frame is transmitted within the loop
+#endif
+
+#ifndef SYSTEM_BUTTON_TASK_BUDGET
+#define SYSTEM_BUTTON_TASK_BUDGET                   2000            // Expander is read over I2C
+#endif
+
+#ifndef SYSTEM_RELAY_TASK_BUDGET
+#define SYSTEM_RELAY_TASK_BUDGET                    1000
+#endif
+
+#ifndef SYSTEM_LED_TASK_BUDGET
+#define SYSTEM_LED_TASK_BUDGET                      500
+#endif
+
 // =============================================================================
 // COMMUNICATION MODULE
 // =============================================================================
@@ -53,6 +86,22 @@ Copyright (C) 2018 FastyBird s.r.o. <code@fastybird.com>
 #define COMMUNICATION_SERIAL_BAUDRATE               38400           // Default baudrate
 #endif
 
+#ifndef COMMUNICATION_SERIAL_MAX_BAUDRATE
+#define COMMUNICATION_SERIAL_MAX_BAUDRATE           COMMUNICATION_SERIAL_BAUDRATE   // Highest baudrate bus transport could run at
+#endif
+
+#ifndef COMMUNICATION_BAUDRATE_SUPPORT
+#define COMMUNICATION_BAUDRATE_SUPPORT              0               // Bus baudrate could be changed by master through attribute register
+#endif
+
+#ifndef COMMUNICATION_BAUDRATE_SWITCH_DELAY
+#define COMMUNICATION_BAUDRATE_SWITCH_DELAY         50              // Delay in ms before new baudrate is applied, so write reply is sent with old one
+#endif
+
+#ifndef COMMUNICATION_BAUDRATE_FALLBACK_TIMEOUT
+#define COMMUNICATION_BAUDRATE_FALLBACK_TIMEOUT     COMMUNICATION_MASTER_PING_TIMEOUT   // Default baudrate is restored when master is not heard
+#endif
+
 #ifndef COMMUNICATION_BUS_HARDWARE_SERIAL
 #define COMMUNICATION_BUS_HARDWARE_SERIAL           0
 #endif
@@ -85,10 +134,42 @@ Copyright (C) 2018 FastyBird s.r.o. <code@fastybird.com>
 #define COMMUNICATION_DISABLE_ADDRESS_STORING       1
 #endif
 
+#ifndef COMMUNICATION_CAPTURE_SUPPORT
+#define COMMUNICATION_CAPTURE_SUPPORT               0               // Stream bus frames to debug serial port, port must not be used by bus
+#endif
+
+#ifndef COMMUNICATION_CAPTURE_BUFFER_SIZE
+#define COMMUNICATION_CAPTURE_BUFFER_SIZE           256             // Captured frames waiting for serial port, whole exchange should fit
+#endif
+
+#ifndef COMMUNICATION_DISCOVER_SLOT_LENGTH
+#define COMMUNICATION_DISCOVER_SLOT_LENGTH          30              // Length of discovery reply slot in ms, whole reply has to fit into it
+#endif
+
 #ifndef COMMUNICATION_NOTIFY_STATE_DELAY
 #define COMMUNICATION_NOTIFY_STATE_DELAY            5000            // Delay before master is notified after boot up
 #endif
 
+#ifndef COMMUNICATION_SUBSCRIPTIONS_SIZE
+#define COMMUNICATION_SUBSCRIPTIONS_SIZE            4               // Count of registers ranges which could be subscribed by master
+#endif
+
+#ifndef COMMUNICATION_REPORT_ACK_TIMEOUT
+#define COMMUNICATION_REPORT_ACK_TIMEOUT            100             // Time in ms to wait for report acknowledge before first retry
+#endif
+
+#ifndef COMMUNICATION_REPORT_BACKOFF_MAX
+#define COMMUNICATION_REPORT_BACKOFF_MAX            3200            // Retries are delayed twice longer after each attempt up to this delay in ms
+#endif
+
+#ifndef COMMUNICATION_REPORT_MAX_RETRIES
+#define COMMUNICATION_REPORT_MAX_RETRIES            6               // Unacknowledged report is dropped after this count of retries
+#endif
+
+#ifndef COMMUNICATION_PACKET_OVERHEAD
+#define COMMUNICATION_PACKET_OVERHEAD               11              // PJON frame overhead (9) with protocol version and terminator (2)
+#endif
+
 #ifndef COMMUNICATION_ATTR_REGISTER_ADDR_ADDRESS
 #define COMMUNICATION_ATTR_REGISTER_ADDR_ADDRESS    0               // Attribute register address where is stored device address
 #endif
@@ -101,22 +182,46 @@ Copyright (C) 2018 FastyBird s.r.o. <code@fastybird.com>
 #define COMMUNICATION_ATTR_REGISTER_STATE_ADDRESS   2               // Attribute register address where is stored device state
 #endif
 
+#ifndef COMMUNICATION_ATTR_REGISTER_MAX_BAUDRATE_ADDRESS
+#define COMMUNICATION_ATTR_REGISTER_MAX_BAUDRATE_ADDRESS    3       // Attribute register address where is published highest supported baudrate
+#endif
+
+#ifndef COMMUNICATION_ATTR_REGISTER_BAUDRATE_ADDRESS
+#define COMMUNICATION_ATTR_REGISTER_BAUDRATE_ADDRESS        4       // Attribute register address where is stored actual bus baudrate
+#endif
+
 // =============================================================================
 // REGISTER MODULE
 // =============================================================================
 
 #ifndef REGISTER_MAX_INPUT_REGISTERS_SIZE
-#define REGISTER_MAX_INPUT_REGISTERS_SIZE           0               // Define maximum size of input registers
+#define REGISTER_MAX_INPUT_REGISTERS_SIZE           (BUTTON_MAX_ITEMS + (BUTTON_EXPANDER_SUPPORT ? BUTTON_EXPANDER_INPUTS : 0))    // Buttons & expander inputs events
 #endif
 
 #ifndef REGISTER_MAX_OUTPUT_REGISTERS_SIZE
-#define REGISTER_MAX_OUTPUT_REGISTERS_SIZE          0               // Define maximum size of output registers
+#define REGISTER_MAX_OUTPUT_REGISTERS_SIZE          RELAY_MAX_ITEMS // Relays states
 #endif
 
 #ifndef REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
 #define REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE       0               // Define maximum size of attribute registers
 #endif
 
+#ifndef REGISTER_JOURNAL_START
+#define REGISTER_JOURNAL_START                      0               // First EEPROM cell used by registers journal
+#endif
+
+#ifndef REGISTER_STORAGE_COMMIT_DELAY
+#define REGISTER_STORAGE_COMMIT_DELAY               RELAY_SAVE_DELAY    // Quiet period before emulated EEPROM row is written into flash
+#endif
+
+#ifndef REGISTER_JOURNAL_RECORDS
+#define REGISTER_JOURNAL_RECORDS                    120             // Count of records in journal ring, must be bigger than count of stored registers
+#endif
+
+#ifndef REGISTER_OBSERVERS_SIZE
+#define REGISTER_OBSERVERS_SIZE                     6               // Count of registers ranges watched by modules for values changes
+#endif
+
 // =============================================================================
 // BUTTON MODULE
 // =============================================================================
@@ -133,6 +238,14 @@ Copyright (C) 2018 FastyBird s.r.o. <code@fastybird.com>
 #define BUTTON_EXPANDER_SUPPORT                     0
 #endif
 
+#ifndef BUTTON_EXPANDER_INT_PIN
+#define BUTTON_EXPANDER_INT_PIN                     GPIO_NONE       // MCU pin wired to mirrored INTA/INTB, GPIO_NONE => inputs are polled
+#endif
+
+#ifndef BUTTON_EXPANDER_POLL_INTERVAL
+#define BUTTON_EXPANDER_POLL_INTERVAL               5               // Inputs reading interval (ms) when interrupt line is not wired
+#endif
+
 // =============================================================================
 // RELAY MODULE
 // =============================================================================
@@ -180,3 +293,31 @@ Copyright (C) 2018 FastyBird s.r.o. <code@fastybird.com>
 #ifndef RELAY_MAX_ITEMS
 #define RELAY_MAX_ITEMS                             0               // Define maximum size of relay items
 #endif
+
+#ifndef RELAY_SCENES_SUPPORT
+#define RELAY_SCENES_SUPPORT                        0               // Relays could be switched by scenes stored in attribute registers
+#endif
+
+#ifndef RELAY_SCENES_SIZE
+#define RELAY_SCENES_SIZE                           8
+#endif
+
+#ifndef RELAY_SCENES_ATTR_REGISTER_START
+#define RELAY_SCENES_ATTR_REGISTER_START            5               // Attribute register address of first scene register
+#endif
+
+// =============================================================================
+// STATS MODULE
+// =============================================================================
+
+#ifndef STATS_SUPPORT
+#define STATS_SUPPORT                               0               // Collect runtime counters & publish them in attribute registers
+#endif
+
+#ifndef STATS_ATTR_REGISTER_START
+#define STATS_ATTR_REGISTER_START                   5               // Attribute register address of first stats register
+#endif
+
+#ifndef STATS_PUBLISH_INTERVAL
+#define STATS_PUBLISH_INTERVAL                      1000            // Loop times window length & registers update interval in ms
+#endif
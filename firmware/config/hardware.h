@@ -37,57 +37,58 @@ Copyright (C) 2018 FastyBird s.r.o. <code@fastybird.com>
     #define BUTTON3_PIN                                 8
     #define BUTTON4_PIN                                 9
 
-    button_t button_module_items[BUTTON_MAX_ITEMS] = {
-        // Debounce instance                                                                                                  AI register address
-        //                                                                                                                       Initial status(event)
-        {new DebounceEvent(BUTTON1_PIN, BUTTON_PUSHBUTTON | BUTTON_SET_PULLUP, BUTTON_DEBOUNCE_DELAY, BUTTON_DBLCLICK_DELAY), 0, BUTTON_EVENT_NONE},
-        {new DebounceEvent(BUTTON2_PIN, BUTTON_PUSHBUTTON | BUTTON_SET_PULLUP, BUTTON_DEBOUNCE_DELAY, BUTTON_DBLCLICK_DELAY), 1, BUTTON_EVENT_NONE},
-        {new DebounceEvent(BUTTON3_PIN, BUTTON_PUSHBUTTON | BUTTON_SET_PULLUP, BUTTON_DEBOUNCE_DELAY, BUTTON_DBLCLICK_DELAY), 2, BUTTON_EVENT_NONE},
-        {new DebounceEvent(BUTTON4_PIN, BUTTON_PUSHBUTTON | BUTTON_SET_PULLUP, BUTTON_DEBOUNCE_DELAY, BUTTON_DBLCLICK_DELAY), 3, BUTTON_EVENT_NONE},
+    constexpr device_button_t device_buttons[] = {
+        // Pin        Has input register
+        {BUTTON1_PIN, true},
+        {BUTTON2_PIN, true},
+        {BUTTON3_PIN, true},
+        {BUTTON4_PIN, true},
     };
 
     // RELAYS
     #define RELAY_PROVIDER                              RELAY_PROVIDER_RELAY
     #define RELAY_MAX_ITEMS                             4
+    #define RELAY_SCENES_SUPPORT                        1
 
     #define RELAY1_PIN                                  A1
     #define RELAY2_PIN                                  A2
     #define RELAY3_PIN                                  A3
     #define RELAY4_PIN                                  A4
 
-    relay_t relay_module_items[RELAY_MAX_ITEMS] = {
-        {RELAY1_PIN, RELAY_TYPE_NORMAL, GPIO_NONE, 0, RELAY_DELAY_ON, RELAY_DELAY_OFF, false, false, 0, 0, 0},
-        {RELAY2_PIN, RELAY_TYPE_NORMAL, GPIO_NONE, 1, RELAY_DELAY_ON, RELAY_DELAY_OFF, false, false, 0, 0, 0},
-        {RELAY3_PIN, RELAY_TYPE_NORMAL, GPIO_NONE, 2, RELAY_DELAY_ON, RELAY_DELAY_OFF, false, false, 0, 0, 0},
-        {RELAY4_PIN, RELAY_TYPE_NORMAL, GPIO_NONE, 3, RELAY_DELAY_ON, RELAY_DELAY_OFF, false, false, 0, 0, 0},
+    constexpr device_relay_t device_relays[] = {
+        // Pin       Relay type         Reset pin
+        {RELAY1_PIN, RELAY_TYPE_NORMAL, GPIO_NONE},
+        {RELAY2_PIN, RELAY_TYPE_NORMAL, GPIO_NONE},
+        {RELAY3_PIN, RELAY_TYPE_NORMAL, GPIO_NONE},
+        {RELAY4_PIN, RELAY_TYPE_NORMAL, GPIO_NONE},
     };
 
     // REGISTERS
-    #define REGISTER_MAX_INPUT_REGISTERS_SIZE           4
-    #define REGISTER_MAX_OUTPUT_REGISTERS_SIZE          4
-    #define REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE       3
-
-    register_io_register_t register_module_input_registers[REGISTER_MAX_INPUT_REGISTERS_SIZE] = {
-        {REGISTER_DATA_TYPE_BUTTON, {0, 0, 0, 0}, INDEX_NONE},
-        {REGISTER_DATA_TYPE_BUTTON, {0, 0, 0, 0}, INDEX_NONE},
-        {REGISTER_DATA_TYPE_BUTTON, {0, 0, 0, 0}, INDEX_NONE},
-        {REGISTER_DATA_TYPE_BUTTON, {0, 0, 0, 0}, INDEX_NONE},
-    };
-    register_io_register_t register_module_output_registers[REGISTER_MAX_OUTPUT_REGISTERS_SIZE] = {
-        {REGISTER_DATA_TYPE_SWITCH, {0, 0, 0, 0}, FLASH_ADDRESS_RELAY_01},
-        {REGISTER_DATA_TYPE_SWITCH, {0, 0, 0, 0}, FLASH_ADDRESS_RELAY_02},
-        {REGISTER_DATA_TYPE_SWITCH, {0, 0, 0, 0}, FLASH_ADDRESS_RELAY_03},
-        {REGISTER_DATA_TYPE_SWITCH, {0, 0, 0, 0}, FLASH_ADDRESS_RELAY_04},
-    };
-    register_attr_register_t register_module_attribute_registers[REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE] = {
+    #define REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE       (5 + RELAY_SCENES_SIZE)
+
+    constexpr register_attr_register_t register_module_attribute_registers[] PROGMEM = {
+        // Name   Data type                 Settable Queryable Default value                        Flash address
         {"address", REGISTER_DATA_TYPE_UINT8, true, true, {PJON_NOT_ASSIGNED, 0, 0, 0}, FLASH_ADDRESS_DEVICE_ADDRESS},
         {"mpl", REGISTER_DATA_TYPE_UINT8, false, true, {PJON_PACKET_MAX_LENGTH, 0, 0, 0}, INDEX_NONE},
         {"state", REGISTER_DATA_TYPE_UINT8, true, true, {DEVICE_STATE_STOPPED_BY_OPERATOR, 0, 0, 0}, FLASH_ADDRESS_DEVICE_STATE},
+        {"max_baud", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"baud", REGISTER_DATA_TYPE_UINT32, true, true, {0, 0, 0, 0}, INDEX_NONE},
+
+        // Relays scenes: low half is mask of output registers, high half their states
+        {"scene_1", REGISTER_DATA_TYPE_UINT32, true, true, {0, 0, 0, 0}, FLASH_ADDRESS_SCENE_01},
+        {"scene_2", REGISTER_DATA_TYPE_UINT32, true, true, {0, 0, 0, 0}, FLASH_ADDRESS_SCENE_02},
+        {"scene_3", REGISTER_DATA_TYPE_UINT32, true, true, {0, 0, 0, 0}, FLASH_ADDRESS_SCENE_03},
+        {"scene_4", REGISTER_DATA_TYPE_UINT32, true, true, {0, 0, 0, 0}, FLASH_ADDRESS_SCENE_04},
+        {"scene_5", REGISTER_DATA_TYPE_UINT32, true, true, {0, 0, 0, 0}, FLASH_ADDRESS_SCENE_05},
+        {"scene_6", REGISTER_DATA_TYPE_UINT32, true, true, {0, 0, 0, 0}, FLASH_ADDRESS_SCENE_06},
+        {"scene_7", REGISTER_DATA_TYPE_UINT32, true, true, {0, 0, 0, 0}, FLASH_ADDRESS_SCENE_07},
+        {"scene_8", REGISTER_DATA_TYPE_UINT32, true, true, {0, 0, 0, 0}, FLASH_ADDRESS_SCENE_08},
     };
 
     // COMMUNICATION
     #define COMMUNICATION_BUS_TX_PIN                    3
     #define COMMUNICATION_BUS_RX_PIN                    2
+    #define COMMUNICATION_BAUDRATE_SUPPORT              1
 #endif
 
 #if defined(FASTYBIRD_IO_TEST_ARM)
@@ -121,56 +122,97 @@ Copyright (C) 2018 FastyBird s.r.o. <code@fastybird.com>
     #define BUTTON3_PIN                                 6
     #define BUTTON4_PIN                                 7
 
-    button_t button_module_items[BUTTON_MAX_ITEMS] = {
-        // Debounce instance                                                                                                  AI register address
-        //                                                                                                                       Initial status(event)
-        {new DebounceEvent(BUTTON1_PIN, BUTTON_PUSHBUTTON | BUTTON_SET_PULLUP, BUTTON_DEBOUNCE_DELAY, BUTTON_DBLCLICK_DELAY), 0, BUTTON_EVENT_NONE},
-        {new DebounceEvent(BUTTON2_PIN, BUTTON_PUSHBUTTON | BUTTON_SET_PULLUP, BUTTON_DEBOUNCE_DELAY, BUTTON_DBLCLICK_DELAY), 1, BUTTON_EVENT_NONE},
-        {new DebounceEvent(BUTTON3_PIN, BUTTON_PUSHBUTTON | BUTTON_SET_PULLUP, BUTTON_DEBOUNCE_DELAY, BUTTON_DBLCLICK_DELAY), 2, BUTTON_EVENT_NONE},
-        {new DebounceEvent(BUTTON4_PIN, BUTTON_PUSHBUTTON | BUTTON_SET_PULLUP, BUTTON_DEBOUNCE_DELAY, BUTTON_DBLCLICK_DELAY), 3, BUTTON_EVENT_NONE},
+    constexpr device_button_t device_buttons[] = {
+        // Pin        Has input register
+        {BUTTON1_PIN, true},
+        {BUTTON2_PIN, true},
+        {BUTTON3_PIN, true},
+        {BUTTON4_PIN, true},
     };
 
     // RELAYS
     #define RELAY_PROVIDER                              RELAY_PROVIDER_RELAY
     #define RELAY_MAX_ITEMS                             4
+    #define RELAY_SCENES_SUPPORT                        1
+    #define RELAY_SCENES_ATTR_REGISTER_START            (5 + STATS_REGISTERS_SIZE)
 
     #define RELAY1_PIN                                  A1
     #define RELAY2_PIN                                  A2
     #define RELAY3_PIN                                  A3
     #define RELAY4_PIN                                  A4
 
-    relay_t relay_module_items[RELAY_MAX_ITEMS] = {
-        {RELAY1_PIN, RELAY_TYPE_NORMAL, GPIO_NONE, 0, RELAY_DELAY_ON, RELAY_DELAY_OFF, false, false, 0, 0, 0},
-        {RELAY2_PIN, RELAY_TYPE_NORMAL, GPIO_NONE, 1, RELAY_DELAY_ON, RELAY_DELAY_OFF, false, false, 0, 0, 0},
-        {RELAY3_PIN, RELAY_TYPE_NORMAL, GPIO_NONE, 2, RELAY_DELAY_ON, RELAY_DELAY_OFF, false, false, 0, 0, 0},
-        {RELAY4_PIN, RELAY_TYPE_NORMAL, GPIO_NONE, 3, RELAY_DELAY_ON, RELAY_DELAY_OFF, false, false, 0, 0, 0},
+    constexpr device_relay_t device_relays[] = {
+        // Pin       Relay type         Reset pin
+        {RELAY1_PIN, RELAY_TYPE_NORMAL, GPIO_NONE},
+        {RELAY2_PIN, RELAY_TYPE_NORMAL, GPIO_NONE},
+        {RELAY3_PIN, RELAY_TYPE_NORMAL, GPIO_NONE},
+        {RELAY4_PIN, RELAY_TYPE_NORMAL, GPIO_NONE},
     };
 
+    // STATS
+    #define STATS_SUPPORT                               1
+
     // REGISTERS
-    #define REGISTER_MAX_INPUT_REGISTERS_SIZE           4
-    #define REGISTER_MAX_OUTPUT_REGISTERS_SIZE          4
-    #define REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE       3
-
-    register_io_register_t register_module_input_registers[REGISTER_MAX_INPUT_REGISTERS_SIZE] = {
-        {REGISTER_DATA_TYPE_BUTTON, {0, 0, 0, 0}, INDEX_NONE},
-        {REGISTER_DATA_TYPE_BUTTON, {0, 0, 0, 0}, INDEX_NONE},
-        {REGISTER_DATA_TYPE_BUTTON, {0, 0, 0, 0}, INDEX_NONE},
-        {REGISTER_DATA_TYPE_BUTTON, {0, 0, 0, 0}, INDEX_NONE},
-    };
-    register_io_register_t register_module_output_registers[REGISTER_MAX_OUTPUT_REGISTERS_SIZE] = {
-        {REGISTER_DATA_TYPE_SWITCH, {0, 0, 0, 0}, FLASH_ADDRESS_RELAY_01},
-        {REGISTER_DATA_TYPE_SWITCH, {0, 0, 0, 0}, FLASH_ADDRESS_RELAY_02},
-        {REGISTER_DATA_TYPE_SWITCH, {0, 0, 0, 0}, FLASH_ADDRESS_RELAY_03},
-        {REGISTER_DATA_TYPE_SWITCH, {0, 0, 0, 0}, FLASH_ADDRESS_RELAY_04},
-    };
-    register_attr_register_t register_module_attribute_registers[REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE] = {
+    #define REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE       (5 + STATS_REGISTERS_SIZE + RELAY_SCENES_SIZE)
+
+    constexpr register_attr_register_t register_module_attribute_registers[] PROGMEM = {
+        // Name   Data type                 Settable Queryable Default value                        Flash address
         {"address", REGISTER_DATA_TYPE_UINT8, true, true, {PJON_NOT_ASSIGNED, 0, 0, 0}, FLASH_ADDRESS_DEVICE_ADDRESS},
         {"mpl", REGISTER_DATA_TYPE_UINT8, false, true, {PJON_PACKET_MAX_LENGTH, 0, 0, 80}, INDEX_NONE},
         {"state", REGISTER_DATA_TYPE_UINT8, true, true, {DEVICE_STATE_STOPPED_BY_OPERATOR, 0, 0, 0}, FLASH_ADDRESS_DEVICE_STATE},
+        {"max_baud", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"baud", REGISTER_DATA_TYPE_UINT32, true, true, {0, 0, 0, 0}, INDEX_NONE},
+
+        // Runtime stats: loop period in us, log2 histogram of loop periods, modules time per loop in us, counters & modules overruns
+        {"loop_min", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"loop_avg", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"loop_max", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"loop_hist_0", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"loop_hist_1", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"loop_hist_2", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"loop_hist_3", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"loop_hist_4", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"loop_hist_5", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"loop_hist_6", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"loop_hist_7", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"button_time", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"relay_time", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"led_time", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"comm_time", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"tx_ack", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"tx_busy", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"tx_fail", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"buffer_full", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"rx_ping", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"rx_discover", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"rx_read", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"rx_write", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"rx_structure", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"rx_subscribe", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"rx_acknowledge", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"rx_other", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"eeprom_writes", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"flash_commits", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"button_overruns", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"relay_overruns", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"led_overruns", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"comm_overruns", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+
+        // Relays scenes: low half is mask of output registers, high half their states
+        {"scene_1", REGISTER_DATA_TYPE_UINT32, true, true, {0, 0, 0, 0}, FLASH_ADDRESS_SCENE_01},
+        {"scene_2", REGISTER_DATA_TYPE_UINT32, true, true, {0, 0, 0, 0}, FLASH_ADDRESS_SCENE_02},
+        {"scene_3", REGISTER_DATA_TYPE_UINT32, true, true, {0, 0, 0, 0}, FLASH_ADDRESS_SCENE_03},
+        {"scene_4", REGISTER_DATA_TYPE_UINT32, true, true, {0, 0, 0, 0}, FLASH_ADDRESS_SCENE_04},
+        {"scene_5", REGISTER_DATA_TYPE_UINT32, true, true, {0, 0, 0, 0}, FLASH_ADDRESS_SCENE_05},
+        {"scene_6", REGISTER_DATA_TYPE_UINT32, true, true, {0, 0, 0, 0}, FLASH_ADDRESS_SCENE_06},
+        {"scene_7", REGISTER_DATA_TYPE_UINT32, true, true, {0, 0, 0, 0}, FLASH_ADDRESS_SCENE_07},
+        {"scene_8", REGISTER_DATA_TYPE_UINT32, true, true, {0, 0, 0, 0}, FLASH_ADDRESS_SCENE_08},
     };
 
     // COMMUNICATION
     #define COMMUNICATION_BUS_HARDWARE_SERIAL           1
+    #define COMMUNICATION_SERIAL_MAX_BAUDRATE           500000      // Serial1 is interrupt driven SERCOM UART
+    #define COMMUNICATION_BAUDRATE_SUPPORT              1
 #endif
 
 #if defined(FASTYBIRD_8CH_BUTTONS) || defined(FASTYBIRD_16CH_BUTTONS)
@@ -226,63 +268,29 @@ Copyright (C) 2018 FastyBird s.r.o. <code@fastybird.com>
         #define BUTTON16_PIN                            A6
     #endif
 
-    button_t button_module_items[BUTTON_MAX_ITEMS] = {
-        // Debounce instance                                                                                                  AI register address
-        //                                                                                                                       Initial status(event)
-        {new DebounceEvent(BUTTON1_PIN, BUTTON_PUSHBUTTON | BUTTON_SET_PULLUP, BUTTON_DEBOUNCE_DELAY, BUTTON_DBLCLICK_DELAY), 0, BUTTON_EVENT_NONE},
-        {new DebounceEvent(BUTTON2_PIN, BUTTON_PUSHBUTTON | BUTTON_SET_PULLUP, BUTTON_DEBOUNCE_DELAY, BUTTON_DBLCLICK_DELAY), 1, BUTTON_EVENT_NONE},
-        {new DebounceEvent(BUTTON3_PIN, BUTTON_PUSHBUTTON | BUTTON_SET_PULLUP, BUTTON_DEBOUNCE_DELAY, BUTTON_DBLCLICK_DELAY), 2, BUTTON_EVENT_NONE},
-        {new DebounceEvent(BUTTON4_PIN, BUTTON_PUSHBUTTON | BUTTON_SET_PULLUP, BUTTON_DEBOUNCE_DELAY, BUTTON_DBLCLICK_DELAY), 3, BUTTON_EVENT_NONE},
-        {new DebounceEvent(BUTTON5_PIN, BUTTON_PUSHBUTTON | BUTTON_SET_PULLUP, BUTTON_DEBOUNCE_DELAY, BUTTON_DBLCLICK_DELAY), 4, BUTTON_EVENT_NONE},
-        {new DebounceEvent(BUTTON6_PIN, BUTTON_PUSHBUTTON | BUTTON_SET_PULLUP, BUTTON_DEBOUNCE_DELAY, BUTTON_DBLCLICK_DELAY), 5, BUTTON_EVENT_NONE},
-        {new DebounceEvent(BUTTON7_PIN, BUTTON_PUSHBUTTON | BUTTON_SET_PULLUP, BUTTON_DEBOUNCE_DELAY, BUTTON_DBLCLICK_DELAY), 6, BUTTON_EVENT_NONE},
-        {new DebounceEvent(BUTTON8_PIN, BUTTON_PUSHBUTTON | BUTTON_SET_PULLUP, BUTTON_DEBOUNCE_DELAY, BUTTON_DBLCLICK_DELAY), 7, BUTTON_EVENT_NONE},
+    constexpr device_button_t device_buttons[] = {
+        // Pin        Has input register
+        {BUTTON1_PIN, true},
+        {BUTTON2_PIN, true},
+        {BUTTON3_PIN, true},
+        {BUTTON4_PIN, true},
+        {BUTTON5_PIN, true},
+        {BUTTON6_PIN, true},
+        {BUTTON7_PIN, true},
+        {BUTTON8_PIN, true},
 
         #if defined(FASTYBIRD_16CH_BUTTONS)
-        {new DebounceEvent(BUTTON9_PIN, BUTTON_PUSHBUTTON | BUTTON_SET_PULLUP, BUTTON_DEBOUNCE_DELAY, BUTTON_DBLCLICK_DELAY), 8, BUTTON_EVENT_NONE},
-        {new DebounceEvent(BUTTON10_PIN, BUTTON_PUSHBUTTON | BUTTON_SET_PULLUP, BUTTON_DEBOUNCE_DELAY, BUTTON_DBLCLICK_DELAY), 9, BUTTON_EVENT_NONE},
-        {new DebounceEvent(BUTTON11_PIN, BUTTON_PUSHBUTTON | BUTTON_SET_PULLUP, BUTTON_DEBOUNCE_DELAY, BUTTON_DBLCLICK_DELAY), 10, BUTTON_EVENT_NONE},
-        {new DebounceEvent(BUTTON12_PIN, BUTTON_PUSHBUTTON | BUTTON_SET_PULLUP, BUTTON_DEBOUNCE_DELAY, BUTTON_DBLCLICK_DELAY), 11, BUTTON_EVENT_NONE},
-        {new DebounceEvent(BUTTON13_PIN, BUTTON_PUSHBUTTON | BUTTON_SET_PULLUP, BUTTON_DEBOUNCE_DELAY, BUTTON_DBLCLICK_DELAY), 12, BUTTON_EVENT_NONE},
-        {new DebounceEvent(BUTTON14_PIN, BUTTON_PUSHBUTTON | BUTTON_SET_PULLUP, BUTTON_DEBOUNCE_DELAY, BUTTON_DBLCLICK_DELAY), 13, BUTTON_EVENT_NONE},
-        {new DebounceEvent(BUTTON15_PIN, BUTTON_PUSHBUTTON | BUTTON_SET_PULLUP, BUTTON_DEBOUNCE_DELAY, BUTTON_DBLCLICK_DELAY), 14, BUTTON_EVENT_NONE},
-        {new DebounceEvent(BUTTON16_PIN, BUTTON_PUSHBUTTON | BUTTON_SET_PULLUP, BUTTON_DEBOUNCE_DELAY, BUTTON_DBLCLICK_DELAY), 15, BUTTON_EVENT_NONE},
+        {BUTTON9_PIN, true},
+        {BUTTON10_PIN, true},
+        {BUTTON11_PIN, true},
+        {BUTTON12_PIN, true},
+        {BUTTON13_PIN, true},
+        {BUTTON14_PIN, true},
+        {BUTTON15_PIN, true},
+        {BUTTON16_PIN, true},
         #endif
     };
 
-    // REGISTERS
-    #if defined(FASTYBIRD_8CH_BUTTONS)
-        #define REGISTER_MAX_INPUT_REGISTERS_SIZE      8
-    #else
-        #define REGISTER_MAX_INPUT_REGISTERS_SIZE      16
-    #endif
-    #define REGISTER_MAX_OUTPUT_REGISTERS_SIZE         0
-    #define REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE      0
-
-    register_io_register_t register_module_input_registers[REGISTER_MAX_INPUT_REGISTERS_SIZE] = {
-        {REGISTER_DATA_TYPE_BUTTON, {0, 0, 0, 0}, INDEX_NONE},
-        {REGISTER_DATA_TYPE_BUTTON, {0, 0, 0, 0}, INDEX_NONE},
-        {REGISTER_DATA_TYPE_BUTTON, {0, 0, 0, 0}, INDEX_NONE},
-        {REGISTER_DATA_TYPE_BUTTON, {0, 0, 0, 0}, INDEX_NONE},
-        {REGISTER_DATA_TYPE_BUTTON, {0, 0, 0, 0}, INDEX_NONE},
-        {REGISTER_DATA_TYPE_BUTTON, {0, 0, 0, 0}, INDEX_NONE},
-        {REGISTER_DATA_TYPE_BUTTON, {0, 0, 0, 0}, INDEX_NONE},
-        {REGISTER_DATA_TYPE_BUTTON, {0, 0, 0, 0}, INDEX_NONE},
-
-        #if defined(FASTYBIRD_16CH_BUTTONS)
-        {REGISTER_DATA_TYPE_BUTTON, {0, 0, 0, 0}, INDEX_NONE},
-        {REGISTER_DATA_TYPE_BUTTON, {0, 0, 0, 0}, INDEX_NONE},
-        {REGISTER_DATA_TYPE_BUTTON, {0, 0, 0, 0}, INDEX_NONE},
-        {REGISTER_DATA_TYPE_BUTTON, {0, 0, 0, 0}, INDEX_NONE},
-        {REGISTER_DATA_TYPE_BUTTON, {0, 0, 0, 0}, INDEX_NONE},
-        {REGISTER_DATA_TYPE_BUTTON, {0, 0, 0, 0}, INDEX_NONE},
-        {REGISTER_DATA_TYPE_BUTTON, {0, 0, 0, 0}, INDEX_NONE},
-        {REGISTER_DATA_TYPE_BUTTON, {0, 0, 0, 0}, INDEX_NONE},
-        #endif
-    };
-    register_io_register_t register_module_output_registers[REGISTER_MAX_OUTPUT_REGISTERS_SIZE];
-    register_attr_register_t register_module_attribute_registers[REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE];
-
     // COMMUNICATION
     #define COMMUNICATION_BUS_TX_PIN                    3
     #define COMMUNICATION_BUS_RX_PIN                    2
@@ -320,10 +328,9 @@ Copyright (C) 2018 FastyBird s.r.o. <code@fastybird.com>
 
     #define BUTTON1_PIN                                 4
 
-    button_t button_module_items[BUTTON_MAX_ITEMS] = {
-        // Debounce instance
-        //                                                                                                                                Initial status(event)
-        {new DebounceEvent(BUTTON1_PIN, BUTTON_PUSHBUTTON | BUTTON_SET_PULLUP, BUTTON_DEBOUNCE_DELAY, BUTTON_DBLCLICK_DELAY), INDEX_NONE, BUTTON_EVENT_NONE},
+    constexpr device_button_t device_buttons[] = {
+        // Pin        Has input register
+        {BUTTON1_PIN, false},
     };
 
     // RELAYS
@@ -353,60 +360,31 @@ Copyright (C) 2018 FastyBird s.r.o. <code@fastybird.com>
         #define RELAY16_PIN                             A6
     #endif
 
-    relay_t relay_module_items[RELAY_MAX_ITEMS] = {
-        {RELAY1_PIN, RELAY_TYPE_NORMAL, GPIO_NONE, 0, RELAY_DELAY_ON, RELAY_DELAY_OFF, false, false, 0, 0, 0},
-        {RELAY2_PIN, RELAY_TYPE_NORMAL, GPIO_NONE, 1, RELAY_DELAY_ON, RELAY_DELAY_OFF, false, false, 0, 0, 0},
-        {RELAY3_PIN, RELAY_TYPE_NORMAL, GPIO_NONE, 2, RELAY_DELAY_ON, RELAY_DELAY_OFF, false, false, 0, 0, 0},
-        {RELAY4_PIN, RELAY_TYPE_NORMAL, GPIO_NONE, 3, RELAY_DELAY_ON, RELAY_DELAY_OFF, false, false, 0, 0, 0},
-        {RELAY5_PIN, RELAY_TYPE_NORMAL, GPIO_NONE, 4, RELAY_DELAY_ON, RELAY_DELAY_OFF, false, false, 0, 0, 0},
-        {RELAY6_PIN, RELAY_TYPE_NORMAL, GPIO_NONE, 5, RELAY_DELAY_ON, RELAY_DELAY_OFF, false, false, 0, 0, 0},
-        {RELAY7_PIN, RELAY_TYPE_NORMAL, GPIO_NONE, 6, RELAY_DELAY_ON, RELAY_DELAY_OFF, false, false, 0, 0, 0},
-        {RELAY8_PIN, RELAY_TYPE_NORMAL, GPIO_NONE, 7, RELAY_DELAY_ON, RELAY_DELAY_OFF, false, false, 0, 0, 0},
+    constexpr device_relay_t device_relays[] = {
+        // Pin       Relay type         Reset pin
+        {RELAY1_PIN, RELAY_TYPE_NORMAL, GPIO_NONE},
+        {RELAY2_PIN, RELAY_TYPE_NORMAL, GPIO_NONE},
+        {RELAY3_PIN, RELAY_TYPE_NORMAL, GPIO_NONE},
+        {RELAY4_PIN, RELAY_TYPE_NORMAL, GPIO_NONE},
+        {RELAY5_PIN, RELAY_TYPE_NORMAL, GPIO_NONE},
+        {RELAY6_PIN, RELAY_TYPE_NORMAL, GPIO_NONE},
+        {RELAY7_PIN, RELAY_TYPE_NORMAL, GPIO_NONE},
+        {RELAY8_PIN, RELAY_TYPE_NORMAL, GPIO_NONE},
 
         #if defined(FASTYBIRD_16CH_DO)
-        {RELAY9_PIN, RELAY_TYPE_NORMAL, GPIO_NONE, 8, RELAY_DELAY_ON, RELAY_DELAY_OFF, false, false, 0, 0, 0},
-        {RELAY10_PIN, RELAY_TYPE_NORMAL, GPIO_NONE, 9, RELAY_DELAY_ON, RELAY_DELAY_OFF, false, false, 0, 0, 0},
-        {RELAY11_PIN, RELAY_TYPE_NORMAL, GPIO_NONE, 10, RELAY_DELAY_ON, RELAY_DELAY_OFF, false, false, 0, 0, 0},
-        {RELAY12_PIN, RELAY_TYPE_NORMAL, GPIO_NONE, 11, RELAY_DELAY_ON, RELAY_DELAY_OFF, false, false, 0, 0, 0},
-        {RELAY13_PIN, RELAY_TYPE_NORMAL, GPIO_NONE, 12, RELAY_DELAY_ON, RELAY_DELAY_OFF, false, false, 0, 0, 0},
-        {RELAY14_PIN, RELAY_TYPE_NORMAL, GPIO_NONE, 13, RELAY_DELAY_ON, RELAY_DELAY_OFF, false, false, 0, 0, 0},
-        {RELAY15_PIN, RELAY_TYPE_NORMAL, GPIO_NONE, 14, RELAY_DELAY_ON, RELAY_DELAY_OFF, false, false, 0, 0, 0},
-        {RELAY16_PIN, RELAY_TYPE_NORMAL, GPIO_NONE, 15, RELAY_DELAY_ON, RELAY_DELAY_OFF, false, false, 0, 0, 0},
+        {RELAY9_PIN, RELAY_TYPE_NORMAL, GPIO_NONE},
+        {RELAY10_PIN, RELAY_TYPE_NORMAL, GPIO_NONE},
+        {RELAY11_PIN, RELAY_TYPE_NORMAL, GPIO_NONE},
+        {RELAY12_PIN, RELAY_TYPE_NORMAL, GPIO_NONE},
+        {RELAY13_PIN, RELAY_TYPE_NORMAL, GPIO_NONE},
+        {RELAY14_PIN, RELAY_TYPE_NORMAL, GPIO_NONE},
+        {RELAY15_PIN, RELAY_TYPE_NORMAL, GPIO_NONE},
+        {RELAY16_PIN, RELAY_TYPE_NORMAL, GPIO_NONE},
         #endif
     };
 
     // REGISTERS
-    #define REGISTER_MAX_INPUT_REGISTERS_SIZE           0
-    #if defined(FASTYBIRD_8CH_DO)
-        #define REGISTER_MAX_OUTPUT_REGISTERS_SIZE      8
-    #else
-        #define REGISTER_MAX_OUTPUT_REGISTERS_SIZE      16
-    #endif
-    #define REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE       0
-
-    register_io_register_t register_module_input_registers[REGISTER_MAX_INPUT_REGISTERS_SIZE];
-    register_io_register_t register_module_output_registers[REGISTER_MAX_OUTPUT_REGISTERS_SIZE] = {
-        {REGISTER_DATA_TYPE_SWITCH, {0, 0, 0, 0}, FLASH_ADDRESS_RELAY_01},
-        {REGISTER_DATA_TYPE_SWITCH, {0, 0, 0, 0}, FLASH_ADDRESS_RELAY_02},
-        {REGISTER_DATA_TYPE_SWITCH, {0, 0, 0, 0}, FLASH_ADDRESS_RELAY_03},
-        {REGISTER_DATA_TYPE_SWITCH, {0, 0, 0, 0}, FLASH_ADDRESS_RELAY_04},
-        {REGISTER_DATA_TYPE_SWITCH, {0, 0, 0, 0}, FLASH_ADDRESS_RELAY_05},
-        {REGISTER_DATA_TYPE_SWITCH, {0, 0, 0, 0}, FLASH_ADDRESS_RELAY_06},
-        {REGISTER_DATA_TYPE_SWITCH, {0, 0, 0, 0}, FLASH_ADDRESS_RELAY_07},
-        {REGISTER_DATA_TYPE_SWITCH, {0, 0, 0, 0}, FLASH_ADDRESS_RELAY_08},
-
-        #if defined(FASTYBIRD_16CH_DO)
-        {REGISTER_DATA_TYPE_SWITCH, {0, 0, 0, 0}, FLASH_ADDRESS_RELAY_09},
-        {REGISTER_DATA_TYPE_SWITCH, {0, 0, 0, 0}, FLASH_ADDRESS_RELAY_10},
-        {REGISTER_DATA_TYPE_SWITCH, {0, 0, 0, 0}, FLASH_ADDRESS_RELAY_11},
-        {REGISTER_DATA_TYPE_SWITCH, {0, 0, 0, 0}, FLASH_ADDRESS_RELAY_12},
-        {REGISTER_DATA_TYPE_SWITCH, {0, 0, 0, 0}, FLASH_ADDRESS_RELAY_13},
-        {REGISTER_DATA_TYPE_SWITCH, {0, 0, 0, 0}, FLASH_ADDRESS_RELAY_14},
-        {REGISTER_DATA_TYPE_SWITCH, {0, 0, 0, 0}, FLASH_ADDRESS_RELAY_15},
-        {REGISTER_DATA_TYPE_SWITCH, {0, 0, 0, 0}, FLASH_ADDRESS_RELAY_16},
-        #endif
-    };
-    register_attr_register_t register_module_attribute_registers[REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE];
+    #define REGISTER_MAX_INPUT_REGISTERS_SIZE           0           // Button is used only for device configuration
 
     // COMMUNICATION
     #define COMMUNICATION_BUS_TX_PIN                    3
@@ -415,18 +393,43 @@ Copyright (C) 2018 FastyBird s.r.o. <code@fastybird.com>
 
 #if defined(FASTYBIRD_16CH_BUTTONS_EXPANDER)
 
-    // Info
+    // GENERAL
     #define SYSTEM_DEVICE_MANUFACTURER                  "FASTYBIRD"
     #define SYSTEM_DEVICE_NAME                          "16CH_BUTTONS_EXPANDER"
+    #define SYSTEM_DEVICE_COMMUNICATION_LED_INDEX       0
 
-    // BUS
-    #define COMMUNICATION_BUS_TX_PIN                    3
-    #define COMMUNICATION_BUS_RX_PIN                    2
+    // LEDS
+    #define LED_MAX_ITEMS                               1
 
-    // LEDs
     #define LED1_PIN                                    13
     #define LED1_PIN_INVERSE                            0
 
-    // Buttons
+    led_t led_module_items[LED_MAX_ITEMS] = {
+        // Pin     Is pin inverted   LED mode      Initial timestamp
+        {LED1_PIN, LED1_PIN_INVERSE, LED_MODE_OFF, 0},
+    };
+
+    // BUTTONS
+    #define BUTTON_MAX_ITEMS                            0
+
+    // EXPANDER BUTTONS
     #define BUTTON_EXPANDER_SUPPORT                     1
+    #define BUTTON_EXPANDER_INT_PIN                     GPIO_NONE   // Set to MCU pin wired to MCP23017 INTA/INTB
+
+    // REGISTERS
+    #define REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE       5
+
+    constexpr register_attr_register_t register_module_attribute_registers[] PROGMEM = {
+        // Name   Data type                 Settable Queryable Default value                        Flash address
+        {"address", REGISTER_DATA_TYPE_UINT8, true, true, {PJON_NOT_ASSIGNED, 0, 0, 0}, FLASH_ADDRESS_DEVICE_ADDRESS},
+        {"mpl", REGISTER_DATA_TYPE_UINT8, false, true, {PJON_PACKET_MAX_LENGTH, 0, 0, 0}, INDEX_NONE},
+        {"state", REGISTER_DATA_TYPE_UINT8, true, true, {DEVICE_STATE_STOPPED_BY_OPERATOR, 0, 0, 0}, FLASH_ADDRESS_DEVICE_STATE},
+        {"max_baud", REGISTER_DATA_TYPE_UINT32, false, true, {0, 0, 0, 0}, INDEX_NONE},
+        {"baud", REGISTER_DATA_TYPE_UINT32, true, true, {0, 0, 0, 0}, INDEX_NONE},
+    };
+
+    // COMMUNICATION
+    #define COMMUNICATION_BUS_TX_PIN                    3
+    #define COMMUNICATION_BUS_RX_PIN                    2
+    #define COMMUNICATION_BAUDRATE_SUPPORT              1
 #endif
\ No newline at end of file
@@ -0,0 +1,155 @@
+/*
+
+DEBUG LOG MESSAGES CATALOG
+
+Copyright (C) 2022 FastyBird s.r.o. <code@fastybird.com>
+
+*/
+
+#pragma once
+
+//------------------------------------------------------------------------------
+// Messages texts are not compiled into firmware, only their identifiers are
+// logged and host decoder is turning them back into text with this catalog
+// Arguments are referenced with %u (decimal) or %x (hexadecimal) conversions
+// Identifiers are assigned by position, so decoder has to be built from same
+// catalog revision as firmware. New messages should be appended at the end
+//------------------------------------------------------------------------------
+
+#define LOG_MESSAGES(MESSAGE) \
+    MESSAGE(LOG_DROPPED,                                        "[LOG][ERR] %u records were dropped, buffer was full") \
+    \
+    MESSAGE(LOG_FIRMWARE_DEVICE_STATE,                          "[FIRMWARE] Device is in %u state") \
+    MESSAGE(LOG_FIRMWARE_RESTARTING,                            "[FIRMWARE] Restarting device") \
+    \
+    MESSAGE(LOG_BUTTON_ITEMS,                                   "[BUTTON] Number of buttons: %u") \
+    MESSAGE(LOG_BUTTON_EVENT,                                   "[BUTTON] Button #%u event %u") \
+    MESSAGE(LOG_BUTTON_PAIRING_MODE,                            "[BUTTON] Activating pairing mode") \
+    MESSAGE(LOG_BUTTON_CLEARING_EEPROM,                         "[BUTTON] Clearing EEPROM") \
+    \
+    MESSAGE(LOG_EXPANDER_ITEMS,                                 "[EXPANDER] Number of buttons: %u") \
+    MESSAGE(LOG_EXPANDER_EVENT,                                 "[EXPANDER] Button #%u event %u") \
+    \
+    MESSAGE(LOG_LED_ITEMS,                                      "[LED] Number of leds: %u") \
+    \
+    MESSAGE(LOG_RELAY_ITEMS,                                    "[RELAY] Number of relays: %u") \
+    MESSAGE(LOG_RELAY_STORED_STATE,                             "[RELAY] Relay #%u stored state %u") \
+    MESSAGE(LOG_RELAY_SET,                                      "[RELAY] #%u set to %u") \
+    MESSAGE(LOG_RELAY_CHANGE_CANCELLED,                         "[RELAY] #%u scheduled change cancelled") \
+    MESSAGE(LOG_RELAY_CHANGE_SCHEDULED,                         "[RELAY] #%u scheduled %u in %u ms") \
+    \
+    MESSAGE(LOG_REGISTER_JOURNAL_FULL,                          "[REGISTER][ERR] Journal is full, value was not stored") \
+    MESSAGE(LOG_REGISTER_WRITTEN,                               "[REGISTER] Value was written into: %u register at address %u") \
+    MESSAGE(LOG_REGISTER_WRITE_SKIPPED,                         "[REGISTER] Value to write into: %u register at address %u is same as stored. Write skipped") \
+    MESSAGE(LOG_REGISTER_JOURNAL_MIGRATION,                     "[REGISTER] Migrating stored values into journal") \
+    MESSAGE(LOG_REGISTER_FLASH_COMMITTED,                       "[REGISTER] Stored values were written into flash") \
+    \
+    MESSAGE(LOG_COMMUNICATION_STORED_ADDRESS_INVALID,           "[COMMUNICATION] Stored address: %u is invalid, reseting to unassigned address") \
+    MESSAGE(LOG_COMMUNICATION_UNADDRESSED,                      "[COMMUNICATION] Unaddressed device") \
+    MESSAGE(LOG_COMMUNICATION_STORED_ADDRESS,                   "[COMMUNICATION] Stored device address: %u") \
+    MESSAGE(LOG_COMMUNICATION_RECEIVED,                         "[COMMUNICATION] Received packet %x with length: %u from address: %u") \
+    MESSAGE(LOG_COMMUNICATION_HANDLED,                          "[COMMUNICATION] Handling received packet finished") \
+    MESSAGE(LOG_COMMUNICATION_WITHOUT_CONTENT,                  "[COMMUNICATION][ERR] Received packet is without content") \
+    MESSAGE(LOG_COMMUNICATION_UNSUPPORTED_VERSION,              "[COMMUNICATION] Received packet for unsupported version %u") \
+    MESSAGE(LOG_COMMUNICATION_UNKNOWN_MASTER,                   "[COMMUNICATION][ERR] Received packet from unknown master address: %u") \
+    MESSAGE(LOG_COMMUNICATION_UNSUPPORTED_PACKET,               "[COMMUNICATION][ERR] Received unsupported packet %x") \
+    MESSAGE(LOG_COMMUNICATION_TOO_SHORT,                        "[COMMUNICATION][ERR] Received packet %x is too short") \
+    MESSAGE(LOG_COMMUNICATION_BROADCAST_TOO_SHORT,              "[COMMUNICATION][ERR] Received broadcast packet is too short") \
+    MESSAGE(LOG_COMMUNICATION_OTHER_DEVICE,                     "[COMMUNICATION][INFO] Packet is for other device") \
+    MESSAGE(LOG_COMMUNICATION_CONNECTION_LOST,                  "[COMMUNICATION][ERR] Connection lost with master") \
+    MESSAGE(LOG_COMMUNICATION_BUFFER_FULL,                      "[COMMUNICATION][ERR] Buffer is full") \
+    MESSAGE(LOG_COMMUNICATION_CONTENT_TOO_LONG,                 "[COMMUNICATION][ERR] Content is long") \
+    MESSAGE(LOG_COMMUNICATION_UNKNOWN_ERROR,                    "[COMMUNICATION][ERR] Unknown error %u") \
+    \
+    MESSAGE(LOG_COMMUNICATION_SEND_BUSY,                        "[COMMUNICATION][ERR] Sending packet to address: %u failed, bus is busy, packet: %x") \
+    MESSAGE(LOG_COMMUNICATION_SEND_FAILED,                      "[COMMUNICATION][ERR] Sending packet to address: %u failed, packet: %x") \
+    MESSAGE(LOG_COMMUNICATION_SEND_ERROR,                       "[COMMUNICATION][ERR] Sending packet to address: %u failed, unknonw error, packet: %x") \
+    MESSAGE(LOG_COMMUNICATION_SENT_BROADCAST,                   "[COMMUNICATION] Successfully sent broadcast packet %x") \
+    MESSAGE(LOG_COMMUNICATION_SENT,                             "[COMMUNICATION] Successfully sent packet: %x to address: %u") \
+    MESSAGE(LOG_COMMUNICATION_PREPARING_REPLY,                  "[COMMUNICATION] Preparing reply packet: %x") \
+    MESSAGE(LOG_COMMUNICATION_REPLY_FAILED,                     "[COMMUNICATION] Sending reply packet failed") \
+    MESSAGE(LOG_COMMUNICATION_PREPARING_BROADCAST,              "[COMMUNICATION] Preparing broadcast packet: %x") \
+    MESSAGE(LOG_COMMUNICATION_BROADCAST_FAILED,                 "[COMMUNICATION] Sending broadcast failed") \
+    \
+    MESSAGE(LOG_COMMUNICATION_EXCEPTION_REPLIED,                "[COMMUNICATION] Replied to master with exception %u") \
+    MESSAGE(LOG_COMMUNICATION_EXCEPTION_NOT_RECEIVED,           "[COMMUNICATION][ERR] Master could not receive exception %u") \
+    MESSAGE(LOG_COMMUNICATION_PONG_REPLIED,                     "[COMMUNICATION] Replied to master with pong") \
+    MESSAGE(LOG_COMMUNICATION_PONG_NOT_RECEIVED,                "[COMMUNICATION][ERR] Master could not receive device pong reply") \
+    MESSAGE(LOG_COMMUNICATION_DISCOVER_SLOT,                    "[COMMUNICATION] Device search request will be replied in slot: %u") \
+    MESSAGE(LOG_COMMUNICATION_DISCOVER_REPLIED,                 "[COMMUNICATION] Replied to master with device search request") \
+    MESSAGE(LOG_COMMUNICATION_DISCOVER_NOT_RECEIVED,            "[COMMUNICATION][ERR] Master could not receive device search request") \
+    MESSAGE(LOG_COMMUNICATION_DISCOVER_SLOT_REPLIED,            "[COMMUNICATION] Replied to master with device search request in slot") \
+    MESSAGE(LOG_COMMUNICATION_DISCOVER_SLOT_NOT_RECEIVED,       "[COMMUNICATION][ERR] Master could not receive device search request in slot") \
+    \
+    MESSAGE(LOG_COMMUNICATION_UNDEFINED_TYPE,                   "[COMMUNICATION][ERR] Master is trying to access undefined registers type: %u") \
+    MESSAGE(LOG_COMMUNICATION_NOT_WRITABLE,                     "[COMMUNICATION][ERR] Attribute register at address: %u is not writtable") \
+    MESSAGE(LOG_COMMUNICATION_NOT_READABLE,                     "[COMMUNICATION][ERR] Attribute register at address: %u is not readable") \
+    MESSAGE(LOG_COMMUNICATION_WRITE_FAILED,                     "[COMMUNICATION][ERR] Value could not be written into register at address: %u") \
+    MESSAGE(LOG_COMMUNICATION_READ_FAILED,                      "[COMMUNICATION][ERR] Value could not be fetched from register at address: %u") \
+    \
+    MESSAGE(LOG_COMMUNICATION_WRITE_MULTIPLE,                   "[COMMUNICATION] Requested writing values to multiple registers of type: %u from address: %u and length: %u") \
+    MESSAGE(LOG_COMMUNICATION_WRITE_MULTIPLE_OUT_OF_RANGE,      "[COMMUNICATION][ERR] Master is trying to write to undefined registers range") \
+    MESSAGE(LOG_COMMUNICATION_WRITE_MULTIPLE_TYPES_MISMATCH,    "[COMMUNICATION][ERR] Received values do not match registers data types") \
+    MESSAGE(LOG_COMMUNICATION_WRITE_MULTIPLE_REPLIED,           "[COMMUNICATION] Replied to master with multiple registers write result") \
+    MESSAGE(LOG_COMMUNICATION_WRITE_MULTIPLE_NOT_RECEIVED,      "[COMMUNICATION][ERR] Master could not receive multiple registers write result") \
+    MESSAGE(LOG_COMMUNICATION_WRITE_SINGLE,                     "[COMMUNICATION] Requested writing value to single register of type: %u at address: %u") \
+    MESSAGE(LOG_COMMUNICATION_WRITE_SINGLE_NOT_FETCHED,         "[COMMUNICATION][ERR] Written value could not be fetched from register") \
+    MESSAGE(LOG_COMMUNICATION_WRITE_SINGLE_REPLIED,             "[COMMUNICATION] Replied to master with register write result") \
+    MESSAGE(LOG_COMMUNICATION_WRITE_SINGLE_NOT_RECEIVED,        "[COMMUNICATION][ERR] Master could not receive register write result") \
+    \
+    MESSAGE(LOG_COMMUNICATION_READ_MULTIPLE,                    "[COMMUNICATION] Requested reading values from multiple registers of type: %u from address: %u and length: %u") \
+    MESSAGE(LOG_COMMUNICATION_READ_MULTIPLE_OUT_OF_RANGE,       "[COMMUNICATION][ERR] Master is trying to read from undefined registers range") \
+    MESSAGE(LOG_COMMUNICATION_READ_MULTIPLE_REPLIED,            "[COMMUNICATION] Replied to master with multiple registers content") \
+    MESSAGE(LOG_COMMUNICATION_READ_MULTIPLE_NOT_RECEIVED,       "[COMMUNICATION][ERR] Master could not receive multiple registers reading") \
+    MESSAGE(LOG_COMMUNICATION_READ_SINGLE,                      "[COMMUNICATION] Requested reading value from single register of type: %u at address: %u") \
+    MESSAGE(LOG_COMMUNICATION_READ_SINGLE_REPLIED,              "[COMMUNICATION] Replied to master with one register content") \
+    MESSAGE(LOG_COMMUNICATION_READ_SINGLE_NOT_RECEIVED,         "[COMMUNICATION][ERR] Master could not receive register reading") \
+    \
+    MESSAGE(LOG_COMMUNICATION_STRUCTURE_SINGLE,                 "[COMMUNICATION] Requested reading structure from single register of type: %u at address: %u") \
+    MESSAGE(LOG_COMMUNICATION_STRUCTURE_OUT_OF_RANGE,           "[COMMUNICATION][ERR] Master is trying to read structure for undefined registers range") \
+    MESSAGE(LOG_COMMUNICATION_STRUCTURE_SINGLE_REPLIED,         "[COMMUNICATION] Replied to master with register structure") \
+    MESSAGE(LOG_COMMUNICATION_STRUCTURE_SINGLE_NOT_RECEIVED,    "[COMMUNICATION][ERR] Master could not receive device register structure") \
+    MESSAGE(LOG_COMMUNICATION_STRUCTURE_MULTIPLE,               "[COMMUNICATION] Requested reading structure from multiple registers of type: %u from address: %u and length: %u") \
+    MESSAGE(LOG_COMMUNICATION_STRUCTURE_TOO_LONG,               "[COMMUNICATION][ERR] Register structure does not fit into packet") \
+    MESSAGE(LOG_COMMUNICATION_STRUCTURE_MULTIPLE_REPLIED,       "[COMMUNICATION] Replied to master with multiple registers structure") \
+    MESSAGE(LOG_COMMUNICATION_STRUCTURE_MULTIPLE_NOT_RECEIVED,  "[COMMUNICATION][ERR] Master could not receive multiple registers structure") \
+    \
+    MESSAGE(LOG_COMMUNICATION_SUBSCRIBE_OUT_OF_RANGE,           "[COMMUNICATION][ERR] Master is trying to subscribe undefined registers range") \
+    MESSAGE(LOG_COMMUNICATION_SUBSCRIPTIONS_FULL,               "[COMMUNICATION][ERR] Subscriptions table is full") \
+    MESSAGE(LOG_COMMUNICATION_SUBSCRIBED,                       "[COMMUNICATION] Subscribed registers: %u from address: %u") \
+    MESSAGE(LOG_COMMUNICATION_SUBSCRIBE_REPLIED,                "[COMMUNICATION] Replied to master with subscription confirmation") \
+    MESSAGE(LOG_COMMUNICATION_SUBSCRIBE_NOT_RECEIVED,           "[COMMUNICATION][ERR] Master could not receive subscription confirmation") \
+    \
+    MESSAGE(LOG_COMMUNICATION_REPORT_DROPPED,                   "[COMMUNICATION][ERR] Report %u was not acknowledged by master, dropping it") \
+    MESSAGE(LOG_COMMUNICATION_REPORT_RETRY,                     "[COMMUNICATION] Report %u was not acknowledged by master, retrying") \
+    MESSAGE(LOG_COMMUNICATION_REPORT_UNEXPECTED_ACK,            "[COMMUNICATION][ERR] Master acknowledged unexpected report %u") \
+    MESSAGE(LOG_COMMUNICATION_REPORT_SINGLE_SENT,               "[COMMUNICATION] Register value was successfully sent") \
+    MESSAGE(LOG_COMMUNICATION_REPORT_MULTIPLE_SENT,             "[COMMUNICATION] Values of %u registers were successfully sent") \
+    \
+    MESSAGE(LOG_COMMUNICATION_VALUE_REJECTED,                   "[COMMUNICATION][ERR] Value is not supported by attribute register at address: %u") \
+    MESSAGE(LOG_COMMUNICATION_BAUDRATE_SWITCHED,                "[COMMUNICATION] Bus baudrate switched to %u") \
+    MESSAGE(LOG_COMMUNICATION_BAUDRATE_FALLBACK,                "[COMMUNICATION][ERR] Master is not heard at %u baudrate, restoring default") \
+    \
+    MESSAGE(LOG_FIRMWARE_TASK_OVERRUN,                          "[FIRMWARE][ERR] Task #%u overrun its budget, it was running %u us") \
+    \
+    MESSAGE(LOG_RELAY_SCENE_APPLIED,                            "[RELAY] Scene #%u applied to %u relays") \
+    MESSAGE(LOG_COMMUNICATION_SCENE_UNKNOWN,                    "[COMMUNICATION][ERR] Received scene #%u is not defined") \
+    MESSAGE(LOG_COMMUNICATION_CAPTURE_DROPPED,                  "[COMMUNICATION][ERR] Capture buffer is full, %u frames were not captured") \
+    MESSAGE(LOG_REGISTER_OBSERVER_NOT_ADDED,                    "[REGISTER][ERR] Observers table is full, %u registers from address %u are not watched") \
+    MESSAGE(LOG_COMMUNICATION_WRITE_SINGLE_OUT_OF_RANGE,        "[COMMUNICATION][ERR] Master is trying to write to undefined register at address: %u") \
+    MESSAGE(LOG_COMMUNICATION_READ_SINGLE_OUT_OF_RANGE,         "[COMMUNICATION][ERR] Master is trying to read from undefined register at address: %u")
+
+// =============================================================================
+// MESSAGES IDENTIFIERS
+// =============================================================================
+
+#define LOG_MESSAGE_IDENTIFIER(id, format) id,
+
+enum log_message_t : uint8_t {
+    LOG_MESSAGES(LOG_MESSAGE_IDENTIFIER)
+    LOG_MESSAGES_SIZE
+};
+
+#undef LOG_MESSAGE_IDENTIFIER
+
+static_assert(LOG_MESSAGES_SIZE < 0xFF, "Log messages identifiers have to fit into one byte");
@@ -60,6 +60,20 @@ typedef union {
     uint8_t     bytes[1];
 } BUTTON_UNION_t;
 
+// =============================================================================
+// CORE MODULE
+// =============================================================================
+
+typedef void (* firmware_task_loop_t)();
+
+// Module loop run by main loop scheduler, tasks priority is given by their order
+typedef struct {
+    firmware_task_loop_t loop;
+    uint16_t period;                            // Min delay between task runs in ms, 0 => every main loop
+    uint16_t budget;                            // Max expected task run time in us, longer run is counted as overrun
+    uint8_t stats_module;                       // Runtime stats module task time is accounted to
+} firmware_task_t;
+
 // =============================================================================
 // COMMUNICATION MODULE
 // =============================================================================
@@ -72,25 +86,66 @@ typedef union {
 
 #include <PJON.h>
 
+typedef void (* communication_packet_handler_t)(uint8_t * payload, const uint16_t length, const bool isBroadcast);
+
+typedef struct {
+    uint8_t packet_id;
+    uint8_t addressing;                         // Accepted addressing of packet
+    uint8_t min_length;                         // Min payload length including packet identifier
+    communication_packet_handler_t handler;
+} communication_packet_t;
+
+// Registers range reported to master by rules instead of every change
+typedef struct {
+    uint8_t register_type;
+    uint8_t register_address;                   // First register of range
+    uint8_t registers_count;                    // 0 => subscription is not used
+    uint16_t min_interval;                      // Min delay between reports in ms
+    uint16_t max_interval;                      // Max delay between reports in s, 0 => no heartbeat
+    uint8_t deadband[4];                        // Min change of value to be reported, in register data type
+    uint32_t last_report;
+} communication_subscription_t;
+
 // =============================================================================
 // REGISTER MODULE
 // =============================================================================
 
+// Attribute register metadata, kept in flash
 typedef struct {
-    uint8_t data_type;
-    uint8_t value[4];
-    uint8_t flash_address;
-} register_io_register_t;
-
-typedef struct {
-    char name[16];
+    char name[REGISTER_ATTRIBUTE_NAME_SIZE];
     uint8_t data_type;
     bool settable;
     bool queryable;
-    uint8_t value[4];
+    uint8_t default_value[4];
     uint8_t flash_address;
 } register_attr_register_t;
 
+typedef void (* register_observer_callback_t)(const uint8_t type, const uint8_t address);
+
+// Registers range watched by module, callback is invoked after value of register in range was changed or written
+typedef struct {
+    uint8_t register_type;
+    uint8_t register_address;                   // First register of range
+    uint8_t registers_count;
+    bool every_write;                           // Callback is invoked also when written value is same as stored
+    register_observer_callback_t callback;
+} register_observer_t;
+
+// =============================================================================
+// DEVICE DESCRIPTOR
+// =============================================================================
+
+typedef struct {
+    uint8_t pin;
+    bool input_register;        // Button events are exposed in input register
+} device_button_t;
+
+typedef struct {
+    uint8_t pin;
+    uint8_t type;
+    uint8_t reset_pin;
+} device_relay_t;
+
 // =============================================================================
 // LED MODULE
 // =============================================================================
@@ -106,10 +161,8 @@ typedef struct {
 // BUTTON MODULE
 // =============================================================================
 
-#include <DebounceEvent.h>
-
 typedef struct {
-    DebounceEvent * button;
+    uint8_t pin;                // GPIO pin, button is pulling up input to ground
     uint8_t register_address;   // Address in communication register to store state
     uint8_t current_status;
 } button_t;
@@ -134,5 +187,5 @@ typedef struct {
     bool target_status;         // Holds the target status
     unsigned long fw_start;     // Flood window start time
     uint8_t fw_count;           // Number of changes within the current flood window
-    unsigned long change_time;  // Scheduled time to change
+    unsigned long change_time;  // Deadline of scheduled change or pulse end
 } relay_t;
@@ -20,6 +20,16 @@ Copyright (C) 2018 FastyBird s.r.o. <code@fastybird.com>
 #define FLASH_ADDRESS_DEVICE_ADDRESS                                0x01
 #define FLASH_ADDRESS_DEVICE_STATE                                  0x02
 
+// Scenes values are read from 4 cells by legacy storage migration, they must not reach relays cells
+#define FLASH_ADDRESS_SCENE_01                                      0x04
+#define FLASH_ADDRESS_SCENE_02                                      0x05
+#define FLASH_ADDRESS_SCENE_03                                      0x06
+#define FLASH_ADDRESS_SCENE_04                                      0x07
+#define FLASH_ADDRESS_SCENE_05                                      0x08
+#define FLASH_ADDRESS_SCENE_06                                      0x09
+#define FLASH_ADDRESS_SCENE_07                                      0x0A
+#define FLASH_ADDRESS_SCENE_08                                      0x0B
+
 #define FLASH_ADDRESS_RELAY_01                                      0x10
 #define FLASH_ADDRESS_RELAY_02                                      0x11
 #define FLASH_ADDRESS_RELAY_03                                      0x12
@@ -37,6 +47,8 @@ Copyright (C) 2018 FastyBird s.r.o. <code@fastybird.com>
 #define FLASH_ADDRESS_RELAY_15                                      0x1E
 #define FLASH_ADDRESS_RELAY_16                                      0x1F
 
+#define FLASH_ADDRESSES_SIZE                                        0x20    // Flash addresses are used as keys of registers journal records
+
 // =============================================================================
 // DEVICE STATES
 // =============================================================================
@@ -52,6 +64,16 @@ Copyright (C) 2018 FastyBird s.r.o. <code@fastybird.com>
 
 #define COMMUNICATION_PACKET_TERMINATOR                             0x00
 #define COMMUNICATION_PACKET_DATA_SPACE                             0x20
+#define COMMUNICATION_REGISTER_ADDRESS_NONE                         0xFFFF  // Register range was read completely, nothing to continue from
+
+#define COMMUNICATION_REGISTER_STRUCTURE_SETTABLE                   0x01    // Attribute structure flags
+#define COMMUNICATION_REGISTER_STRUCTURE_QUERYABLE                  0x02
+
+#define COMMUNICATION_CAPTURE_MARKER                                "@"     // Capture lines could be mixed with debug log
+#define COMMUNICATION_CAPTURE_RECEIVED                              'R'
+#define COMMUNICATION_CAPTURE_TRANSMITTED                           'T'
+#define COMMUNICATION_CAPTURE_RECORD_HEADER_SIZE                    8       // Timestamp (4), direction, sender, receiver, frame length
+#define COMMUNICATION_CAPTURE_LINE_HEADER_SIZE                      24      // "@<timestamp>,<direction>,<sender>,<receiver>,"
 
 #define COMMUNICATION_PACKET_PING                                   0x01
 #define COMMUNICATION_PACKET_PONG                                   0x02
@@ -65,6 +87,23 @@ Copyright (C) 2018 FastyBird s.r.o. <code@fastybird.com>
 #define COMMUNICATION_PACKET_READ_SINGLE_REGISTER_STRUCTURE         0x25
 #define COMMUNICATION_PACKET_READ_MULTIPLE_REGISTER_STRUCTURE       0x26
 #define COMMUNICATION_PACKET_REPORT_SINGLE_REGISTER_VALUE           0x27
+#define COMMUNICATION_PACKET_REPORT_MULTIPLE_REGISTERS_VALUES       0x28
+#define COMMUNICATION_PACKET_SUBSCRIBE_REGISTERS                    0x29
+#define COMMUNICATION_PACKET_REPORT_ACKNOWLEDGE                     0x2A
+#define COMMUNICATION_PACKET_SCENE                                  0x2B
+
+#define COMMUNICATION_EXCEPTION_NONE                                0x00
+#define COMMUNICATION_EXCEPTION_UNSUPPORTED_PACKET                  0x01
+#define COMMUNICATION_EXCEPTION_OUT_OF_RANGE                        0x02    // Register type or address does not exist
+#define COMMUNICATION_EXCEPTION_NOT_WRITABLE                        0x03
+#define COMMUNICATION_EXCEPTION_NOT_READABLE                        0x04
+#define COMMUNICATION_EXCEPTION_BAD_LENGTH                          0x05    // Packet or value length does not match
+#define COMMUNICATION_EXCEPTION_BUSY                                0x06    // Device could not accept request now
+
+#define COMMUNICATION_PACKET_ADDRESSING_NONE                        0x00
+#define COMMUNICATION_PACKET_ADDRESSING_UNICAST                     0x01    // Packet addressed to this device
+#define COMMUNICATION_PACKET_ADDRESSING_BROADCAST                   0x02    // Packet addressed to all devices
+#define COMMUNICATION_PACKET_ADDRESSING_UNASSIGNED                  0x04    // Broadcast packet handled only by device without address
 
 // =============================================================================
 // REGISTER
@@ -74,6 +113,17 @@ Copyright (C) 2018 FastyBird s.r.o. <code@fastybird.com>
 #define REGISTER_TYPE_OUTPUT                                        0x02
 #define REGISTER_TYPE_ATTRIBUTE                                     0x03
 
+#define REGISTER_ATTRIBUTE_NAME_SIZE                                16          // Attribute name including terminator
+
+// =============================================================================
+// REGISTER JOURNAL
+// =============================================================================
+
+#define REGISTER_JOURNAL_MAGIC                                      0x46424A31  // "FBJ1"
+#define REGISTER_JOURNAL_HEADER_SIZE                                4
+#define REGISTER_JOURNAL_RECORD_SIZE                                8           // Sequence (2), key (1), value (4), CRC (1)
+#define REGISTER_JOURNAL_SEQUENCE_REFRESH                           0x4000      // Records older than this are moved to the journal head
+
 // =============================================================================
 // REGISTER VALUES CONSTANTS
 // =============================================================================
@@ -123,10 +173,13 @@ Copyright (C) 2018 FastyBird s.r.o. <code@fastybird.com>
 #define BUTTON_EVENT_LNGLNGCLICK                                    7
 
 #define BUTTON_DEBOUNCE_DELAY                                       50      // Debounce delay (ms)
+#define BUTTON_DEBOUNCE_SAMPLE_INTERVAL                             (BUTTON_DEBOUNCE_DELAY / 4)    // Inputs sampling (ms), 2 bit vertical counter needs 4 stable samples
 #define BUTTON_DBLCLICK_DELAY                                       350     // Time in ms to wait for a second (or third...) click
 #define BUTTON_LNGCLICK_DELAY                                       900     // Time in ms holding the button down to get a long click
 #define BUTTON_LNGLNGCLICK_DELAY                                    2500    // Time in ms holding the button down to get a long-long click
 
+#define BUTTON_EXPANDER_INPUTS                                      16      // MCP23017 GPIOA & GPIOB
+
 // =============================================================================
 // RELAY
 // =============================================================================
@@ -159,3 +212,59 @@ Copyright (C) 2018 FastyBird s.r.o. <code@fastybird.com>
 
 #define RELAY_DELAY_ON                                              0
 #define RELAY_DELAY_OFF                                             0
+
+// =============================================================================
+// RELAY TIMER WHEEL
+// =============================================================================
+
+#define RELAY_TIMER_WHEEL_TICK_SHIFT                                3           // Tick is 8 ms
+#define RELAY_TIMER_WHEEL_TICK                                      (1UL << RELAY_TIMER_WHEEL_TICK_SHIFT)
+#define RELAY_TIMER_WHEEL_SLOT_BITS                                 3
+#define RELAY_TIMER_WHEEL_SLOTS                                     (1 << RELAY_TIMER_WHEEL_SLOT_BITS)
+#define RELAY_TIMER_WHEEL_LEVELS                                    3           // 64 ms, 512 ms and 4 s per level rotation
+
+// =============================================================================
+// STATS
+// =============================================================================
+
+#define STATS_MODULE_BUTTON                                         0
+#define STATS_MODULE_RELAY                                          1
+#define STATS_MODULE_LED                                            2
+#define STATS_MODULE_COMMUNICATION                                  3
+
+#define STATS_MODULES_SIZE                                          4
+
+#define STATS_COUNTER_TX_ACK                                        0
+#define STATS_COUNTER_TX_BUSY                                       1
+#define STATS_COUNTER_TX_FAIL                                       2
+#define STATS_COUNTER_BUFFER_FULL                                   3
+#define STATS_COUNTER_RX_PING                                       4
+#define STATS_COUNTER_RX_DISCOVER                                   5
+#define STATS_COUNTER_RX_READ                                       6       // Reading single & multiple registers values
+#define STATS_COUNTER_RX_WRITE                                      7
+#define STATS_COUNTER_RX_STRUCTURE                                  8
+#define STATS_COUNTER_RX_SUBSCRIBE                                  9
+#define STATS_COUNTER_RX_ACKNOWLEDGE                                10
+#define STATS_COUNTER_RX_OTHER                                      11
+#define STATS_COUNTER_EEPROM_WRITES                                 12      // Registers journal records
+#define STATS_COUNTER_FLASH_COMMITS                                 13      // Emulated EEPROM rows written into flash
+
+#define STATS_COUNTERS_SIZE                                         14
+
+#define STATS_LOOP_HISTOGRAM_SIZE                                   8
+#define STATS_LOOP_HISTOGRAM_SHIFT                                  7       // First bucket is holding periods up to 255 us
+
+// Registers order: loop min, avg & max, loop histogram, modules times, counters & modules overruns
+#define STATS_REGISTERS_SIZE                                        (3 + STATS_LOOP_HISTOGRAM_SIZE + STATS_MODULES_SIZE + STATS_COUNTERS_SIZE + STATS_MODULES_SIZE)
+
+// =============================================================================
+// DEBUG LOG
+// =============================================================================
+
+// Record: sync, length of rest, message identifier, time delta & arguments
+// Time delta to previous record and arguments are unsigned LEB128 varints
+#define LOG_RECORD_SYNC                                             0xFB    // Could not appear in text lines of bus capture
+#define LOG_RECORD_HEADER_LENGTH                                    2
+#define LOG_RECORD_ARGUMENTS_MAX                                    3
+#define LOG_RECORD_VARINT_MAX_LENGTH                                5
+#define LOG_RECORD_MAX_LENGTH                                       (LOG_RECORD_HEADER_LENGTH + 1 + (1 + LOG_RECORD_ARGUMENTS_MAX) * LOG_RECORD_VARINT_MAX_LENGTH)
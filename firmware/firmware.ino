@@ -16,6 +16,9 @@ bool _firmwareIsBooting = false;
 bool _firmwareIsDiscoverable = false;
 uint32_t _firmwareReboot = 0;
 
+// Device state register value, updated by register observer
+uint8_t _firmware_device_state = DEVICE_STATE_STOPPED;
+
 // -----------------------------------------------------------------------------
 // FIRMWARE BASIC API
 // -----------------------------------------------------------------------------
@@ -40,21 +43,7 @@ void firmwareSetDeviceState(
 
 uint8_t firmwareGetDeviceState()
 {
-    uint8_t device_state;
-
-    registerReadRegister(REGISTER_TYPE_ATTRIBUTE, COMMUNICATION_ATTR_REGISTER_STATE_ADDRESS, device_state);
-
-    // Check if valid value is stored in registry
-    if (
-        device_state != DEVICE_STATE_RUNNING
-        && device_state != DEVICE_STATE_STOPPED
-        && device_state != DEVICE_STATE_STOPPED_BY_OPERATOR
-        && device_state != DEVICE_STATE_ERROR
-    ) {
-        return DEVICE_STATE_ERROR;
-    }
-
-    return device_state;
+    return _firmware_device_state;
 }
 
 // -----------------------------------------------------------------------------
@@ -100,6 +89,133 @@ void firmwareSetReboot()
     _firmwareReboot = millis();
 }
 
+// -----------------------------------------------------------------------------
+// DEVICE STATE
+// -----------------------------------------------------------------------------
+
+void _firmwareDeviceStateChanged(
+    const uint8_t type,
+    const uint8_t address
+) {
+    uint8_t device_state = DEVICE_STATE_ERROR;
+
+    registerReadRegister(REGISTER_TYPE_ATTRIBUTE, COMMUNICATION_ATTR_REGISTER_STATE_ADDRESS, device_state);
+
+    // Check if valid value is stored in registry
+    if (
+        device_state != DEVICE_STATE_RUNNING
+        && device_state != DEVICE_STATE_STOPPED
+        && device_state != DEVICE_STATE_STOPPED_BY_OPERATOR
+        && device_state != DEVICE_STATE_ERROR
+    ) {
+        device_state = DEVICE_STATE_ERROR;
+    }
+
+    _firmware_device_state = device_state;
+}
+
+// -----------------------------------------------------------------------------
+// SCHEDULER
+// -----------------------------------------------------------------------------
+
+// Modules loops in order of their priority
+const firmware_task_t _firmware_tasks[] PROGMEM = {
+    // Loop                 Period                              Budget                              Stats module
+    {communicationLoop,     SYSTEM_COMMUNICATION_TASK_PERIOD,   SYSTEM_COMMUNICATION_TASK_BUDGET,   STATS_MODULE_COMMUNICATION},
+
+    #if BUTTON_MAX_ITEMS
+        {buttonLoop,        SYSTEM_BUTTON_TASK_PERIOD,          SYSTEM_BUTTON_TASK_BUDGET,          STATS_MODULE_BUTTON},
+    #endif
+
+    #if BUTTON_EXPANDER_SUPPORT
+        {expanderLoop,      SYSTEM_BUTTON_TASK_PERIOD,          SYSTEM_BUTTON_TASK_BUDGET,          STATS_MODULE_BUTTON},
+    #endif
+
+    #if RELAY_PROVIDER != RELAY_PROVIDER_NONE
+        {relayLoop,         SYSTEM_RELAY_TASK_PERIOD,           SYSTEM_RELAY_TASK_BUDGET,           STATS_MODULE_RELAY},
+    #endif
+
+    {ledLoop,               SYSTEM_LED_TASK_PERIOD,             SYSTEM_LED_TASK_BUDGET,             STATS_MODULE_LED},
+};
+
+#define FIRMWARE_TASKS_SIZE     (sizeof(_firmware_tasks) / sizeof(firmware_task_t))
+
+uint32_t _firmware_tasks_next_run[FIRMWARE_TASKS_SIZE];
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Run module loop when its period elapsed, returns true when periodic task was run
+ */
+bool _firmwareRunTask(
+    const uint8_t index
+) {
+    firmware_task_t task;
+
+    memcpy_P(&task, &_firmware_tasks[index], sizeof(firmware_task_t));
+
+    uint32_t now = millis();
+
+    if (task.period > 0) {
+        if ((int32_t) (now - _firmware_tasks_next_run[index]) < 0) {
+            return false;
+        }
+
+        // Missed periods are not caught up, task is delayed instead
+        if ((now - _firmware_tasks_next_run[index]) >= task.period) {
+            _firmware_tasks_next_run[index] = now + task.period;
+
+        } else {
+            _firmware_tasks_next_run[index] += task.period;
+        }
+    }
+
+    #if STATS_SUPPORT || DEBUG_SUPPORT
+        uint32_t start = micros();
+    #endif
+
+    task.loop();
+
+    #if STATS_SUPPORT || DEBUG_SUPPORT
+        uint32_t elapsed = micros() - start;
+
+        if (elapsed > task.budget) {
+            #if STATS_SUPPORT
+                statsModuleOverrun(task.stats_module);
+            #endif
+
+            #if DEBUG_SUPPORT
+                DLOG(LOG_FIRMWARE_TASK_OVERRUN, index, elapsed);
+            #endif
+        }
+    #endif
+
+    #if STATS_SUPPORT
+        statsModuleFinished(task.stats_module);
+    #endif
+
+    return task.period > 0;
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Work which could wait for main loop without any due module task
+ */
+void _firmwareIdle()
+{
+    #if COMMUNICATION_CAPTURE_SUPPORT
+        // Log records could not be written in the middle of capture line
+        if (communicationCaptureLoop() == false) {
+            return;
+        }
+    #endif
+
+    #if DEBUG_SUPPORT
+        logLoop();
+    #endif
+}
+
 // -----------------------------------------------------------------------------
 // BOOTING
 // -----------------------------------------------------------------------------
@@ -116,9 +232,26 @@ void setup()
 
     registerSetup();
 
+    #if REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
+        // Device state is cached, so modules are not reading it from register in each loop
+        if (registerAddObserver(REGISTER_TYPE_ATTRIBUTE, COMMUNICATION_ATTR_REGISTER_STATE_ADDRESS, 1, _firmwareDeviceStateChanged, false)) {
+            _firmwareDeviceStateChanged(REGISTER_TYPE_ATTRIBUTE, COMMUNICATION_ATTR_REGISTER_STATE_ADDRESS);
+
+        } else {
+            // Cached state could not follow master requests, device must not run with it
+            _firmware_device_state = DEVICE_STATE_ERROR;
+        }
+    #endif
+
+    #if STATS_SUPPORT
+        statsSetup();
+    #endif
+
     communicationSetup();
 
-    buttonSetup();
+    #if BUTTON_MAX_ITEMS
+        buttonSetup();
+    #endif
 
     #if BUTTON_EXPANDER_SUPPORT
         expanderSetup();
@@ -130,10 +263,19 @@ void setup()
 
     ledSetup();
 
+    for (uint8_t i = 0; i < FIRMWARE_TASKS_SIZE; i++) {
+        _firmware_tasks_next_run[i] = millis();
+    }
+
     #if DEBUG_SUPPORT
-        DPRINT(F("[FIRMWARE] Device is in "));
-        DPRINT(firmwareGetDeviceState());
-        DPRINTLN(F(" state"));
+        DLOG(LOG_FIRMWARE_DEVICE_STATE, firmwareGetDeviceState());
+
+        // Boot is not time critical, records which did not fit into buffer are sent now
+        logFlush();
+    #endif
+
+    #if COMMUNICATION_CAPTURE_SUPPORT
+        communicationCaptureFlush();
     #endif
 
     _firmwareIsBooting = false;
@@ -143,23 +285,45 @@ void setup()
 
 void loop()
 {
-    buttonLoop();
-
-    #if BUTTON_EXPANDER_SUPPORT
-        expanderLoop();
+    #if STATS_SUPPORT
+        statsLoop();
     #endif
 
-    #if RELAY_PROVIDER != RELAY_PROVIDER_NONE
-        relayLoop();
-    #endif
+    bool is_idle = true;
+
+    for (uint8_t i = 0; i < FIRMWARE_TASKS_SIZE; i++) {
+        if (_firmwareRunTask(i)) {
+            is_idle = false;
+
+            // Bus frame received meanwhile is handled before next lower priority task
+            communicationReceive();
 
-    ledLoop();
+            #if STATS_SUPPORT
+                statsModuleFinished(STATS_MODULE_COMMUNICATION);
+            #endif
+        }
+    }
+
+    registerLoop();
 
-    communicationLoop();
+    if (is_idle) {
+        _firmwareIdle();
+    }
 
     if (_firmwareReboot > 0 && (millis() - _firmwareReboot) > SYSTEM_RESTART_DELAY) {
         #if DEBUG_SUPPORT
-            DPRINTLN(F("[FIRMWARE] Restarting device"));
+            DLOG(LOG_FIRMWARE_RESTARTING);
+        #endif
+
+        // Pending values have to be stored before restart
+        registerCommitStorage();
+
+        #if COMMUNICATION_CAPTURE_SUPPORT
+            communicationCaptureFlush();
+        #endif
+
+        #if DEBUG_SUPPORT
+            logFlush();
         #endif
 
         delay(250);
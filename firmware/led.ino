@@ -126,8 +126,7 @@ void ledSetup()
     _ledConfigure();
 
     #if DEBUG_SUPPORT
-        DPRINT(F("[LED] Number of leds: "));
-        DPRINTLN(LED_MAX_ITEMS);
+        DLOG(LOG_LED_ITEMS, LED_MAX_ITEMS);
     #endif
 }
 
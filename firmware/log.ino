@@ -0,0 +1,219 @@
+/*
+
+LOG MODULE
+
+Copyright (C) 2022 FastyBird s.r.o. <code@fastybird.com>
+
+Debug messages are stored as binary records in RAM ring and are sent to serial
+line only when there is space in serial transmit buffer, so logging is never
+stalling the main loop. Texts are restored by host decoder from config/log.h
+
+*/
+
+#if DEBUG_SUPPORT
+
+#include "config/all.h"
+
+#include <Arduino.h>
+
+static_assert(LOG_BUFFER_SIZE >= 2 * LOG_RECORD_MAX_LENGTH, "Log buffer has to hold at least two records");
+
+uint8_t _log_buffer[LOG_BUFFER_SIZE];
+
+uint16_t _log_head = 0;
+uint16_t _log_tail = 0;
+uint16_t _log_used = 0;
+
+// Records which did not fit into buffer since last stored record
+uint32_t _log_dropped = 0;
+
+uint32_t _log_last_timestamp = 0;
+
+// -----------------------------------------------------------------------------
+// MODULE PRIVATE
+// -----------------------------------------------------------------------------
+
+uint8_t _logEncodeVarint(
+    uint32_t value,
+    uint8_t * output
+) {
+    uint8_t length = 0;
+
+    while (value >= 0x80) {
+        output[length++] = (uint8_t) (value | 0x80);
+
+        value = value >> 7;
+    }
+
+    output[length++] = (uint8_t) value;
+
+    return length;
+}
+
+// -----------------------------------------------------------------------------
+
+bool _logStore(
+    const uint8_t messageId,
+    const uint32_t * arguments,
+    const uint8_t argumentsCount
+) {
+    uint8_t record[LOG_RECORD_MAX_LENGTH];
+    uint8_t length = LOG_RECORD_HEADER_LENGTH;
+
+    uint32_t now = millis();
+
+    // 0    => Sync byte
+    // 1    => Length of record without header
+    // 2    => Message identifier
+    // 3-n  => Time since previous record & arguments
+    record[length++] = messageId;
+
+    length += _logEncodeVarint(now - _log_last_timestamp, &record[length]);
+
+    for (uint8_t i = 0; i < argumentsCount && i < LOG_RECORD_ARGUMENTS_MAX; i++) {
+        length += _logEncodeVarint(arguments[i], &record[length]);
+    }
+
+    record[0] = LOG_RECORD_SYNC;
+    record[1] = length - LOG_RECORD_HEADER_LENGTH;
+
+    if ((uint16_t) (LOG_BUFFER_SIZE - _log_used) < length) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < length; i++) {
+        _log_buffer[_log_head] = record[i];
+
+        _log_head = (_log_head + 1) % LOG_BUFFER_SIZE;
+    }
+
+    _log_used += length;
+    _log_last_timestamp = now;
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Whole records are written to serial line, so they are not mixed with other output
+ */
+bool _logSendRecord(
+    const bool blocking
+) {
+    if (_log_used == 0) {
+        return false;
+    }
+
+    uint8_t length = LOG_RECORD_HEADER_LENGTH + _log_buffer[(_log_tail + 1) % LOG_BUFFER_SIZE];
+
+    if (blocking == false && Serial.availableForWrite() < length) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < length; i++) {
+        Serial.write(_log_buffer[_log_tail]);
+
+        _log_tail = (_log_tail + 1) % LOG_BUFFER_SIZE;
+    }
+
+    _log_used -= length;
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void _logWrite(
+    const uint8_t messageId,
+    const uint32_t * arguments,
+    const uint8_t argumentsCount
+) {
+    if (_log_dropped > 0) {
+        if (_logStore(LOG_DROPPED, &_log_dropped, 1) == false) {
+            _log_dropped++;
+
+            return;
+        }
+
+        _log_dropped = 0;
+    }
+
+    if (_logStore(messageId, arguments, argumentsCount) == false) {
+        _log_dropped++;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// MODULE API
+// -----------------------------------------------------------------------------
+
+void logWrite(
+    const uint8_t messageId
+) {
+    _logWrite(messageId, NULL, 0);
+}
+
+// -----------------------------------------------------------------------------
+
+void logWrite(
+    const uint8_t messageId,
+    const uint32_t argument
+) {
+    _logWrite(messageId, &argument, 1);
+}
+
+// -----------------------------------------------------------------------------
+
+void logWrite(
+    const uint8_t messageId,
+    const uint32_t argument1,
+    const uint32_t argument2
+) {
+    uint32_t arguments[2] = { argument1, argument2 };
+
+    _logWrite(messageId, arguments, 2);
+}
+
+// -----------------------------------------------------------------------------
+
+void logWrite(
+    const uint8_t messageId,
+    const uint32_t argument1,
+    const uint32_t argument2,
+    const uint32_t argument3
+) {
+    uint32_t arguments[3] = { argument1, argument2, argument3 };
+
+    _logWrite(messageId, arguments, 3);
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Send all pending records, could be used only where blocking is acceptable (boot, restart)
+ */
+void logFlush()
+{
+    while (_logSendRecord(true)) {
+        // Sending next record
+    }
+
+    Serial.flush();
+}
+
+// -----------------------------------------------------------------------------
+// MODULE CORE
+// -----------------------------------------------------------------------------
+
+/**
+ * Has to be called at the end of main loop, records are sent while they fit into serial transmit buffer
+ */
+void logLoop()
+{
+    while (_logSendRecord(false)) {
+        // Sending next record
+    }
+}
+
+#endif // DEBUG_SUPPORT
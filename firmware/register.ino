@@ -16,326 +16,461 @@ Copyright (C) 2022 FastyBird s.r.o. <code@fastybird.com>
     #include <../lib/ArmEeprom/Samd21Eeprom.h>
 #endif
 
-// -----------------------------------------------------------------------------
-// REGISTERS HELPERS
-// -----------------------------------------------------------------------------
-
-void _registerWriteToEeprom(
-    const uint8_t type,
-    const uint8_t address,
-    const uint8_t flashAddress,
-    const uint8_t * value
-) {
-    uint8_t data_type = registerGetRegisterDataType(type, address);
+// Values of all registers in one block: inputs, outputs & attributes, metadata are kept in flash
+uint8_t _register_values[DEVICE_REGISTERS_SIZE][4];
 
-    switch (data_type)
-    {
+// Index of first register value & count of registers, indexed by registers type
+const uint8_t _register_values_offset[REGISTER_TYPE_ATTRIBUTE + 1] = {
+    0,
+    0,
+    REGISTER_MAX_INPUT_REGISTERS_SIZE,
+    REGISTER_MAX_INPUT_REGISTERS_SIZE + REGISTER_MAX_OUTPUT_REGISTERS_SIZE,
+};
+const uint8_t _register_values_size[REGISTER_TYPE_ATTRIBUTE + 1] = {
+    0,
+    REGISTER_MAX_INPUT_REGISTERS_SIZE,
+    REGISTER_MAX_OUTPUT_REGISTERS_SIZE,
+    REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE,
+};
 
-        case REGISTER_DATA_TYPE_UINT8:
-        case REGISTER_DATA_TYPE_INT8:
-        case REGISTER_DATA_TYPE_BUTTON:
-        case REGISTER_DATA_TYPE_SWITCH:
-        {
-            EEPROM.update(flashAddress, value[0]);
-            break;
-        }
+// Journal slot of newest record for each flash address or INDEX_NONE
+uint8_t _register_journal_slots[FLASH_ADDRESSES_SIZE];
 
-        case REGISTER_DATA_TYPE_UINT16:
-        case REGISTER_DATA_TYPE_INT16:
-        {
-            EEPROM.update(flashAddress, value[0]);
-            EEPROM.update((flashAddress + 1), value[1]);
-            break;
-        }
+uint8_t _register_journal_head = 0;
+uint16_t _register_journal_sequence = 0;
 
-        case REGISTER_DATA_TYPE_UINT32:
-        case REGISTER_DATA_TYPE_INT32:
-        case REGISTER_DATA_TYPE_FLOAT32:
-        {
-            EEPROM.update(flashAddress, value[0]);
-            EEPROM.update((flashAddress + 1), value[1]);
-            EEPROM.update((flashAddress + 2), value[2]);
-            EEPROM.update((flashAddress + 3), value[3]);
-            break;
-        }
+bool _register_journal_ready = false;
 
-        case REGISTER_DATA_TYPE_BOOLEAN:
-        {
-            BOOLEAN_UNION_t bool_write_value;
+// Modules callbacks invoked on registers values changes
+register_observer_t _register_observers[REGISTER_OBSERVERS_SIZE];
 
-            bool_write_value.bytes[0] = value[0];
-            bool_write_value.bytes[1] = value[1];
-            bool_write_value.bytes[2] = value[2];
-            bool_write_value.bytes[3] = value[3];
+uint8_t _register_observers_count = 0;
 
-            EEPROM.update(flashAddress, (bool_write_value.number == REGISTER_BOOLEAN_VALUE_TRUE));
-            break;
-        }
+// -----------------------------------------------------------------------------
+// REGISTERS JOURNAL
+// -----------------------------------------------------------------------------
 
-    }
+/**
+ * Persisted registers values are appended as records into a ring across EEPROM
+ *
+ * Header:
+ * 0-3  => Journal magic
+ *
+ * Record:
+ * 0    => Low byte of record sequence
+ * 1    => High byte of record sequence
+ * 2    => Record key - register flash address
+ * 3-6  => Register value
+ * 7    => CRC of record bytes 0-6
+ */
+uint16_t _registerJournalRecordAddress(
+    const uint8_t slot
+) {
+    return REGISTER_JOURNAL_START + REGISTER_JOURNAL_HEADER_SIZE + (slot * REGISTER_JOURNAL_RECORD_SIZE);
 }
 
-void _registerInitializeFromEeprom(
-    const uint8_t type,
-    const uint8_t address,
-    const uint8_t flashAddress
+// -----------------------------------------------------------------------------
+
+uint8_t _registerJournalCrc(
+    const uint8_t * data,
+    const uint8_t length
 ) {
-    uint8_t data_type = registerGetRegisterDataType(type, address);
+    // CRC-8, poly 0x07 with non zero init value, so erased or cleared cells are not valid record
+    uint8_t crc = 0xFF;
 
-    switch (data_type)
-    {
-        case REGISTER_DATA_TYPE_UINT8:
-            UINT8_UNION_t uint8_stored_value;
+    for (uint8_t i = 0; i < length; i++) {
+        crc ^= data[i];
 
-            uint8_stored_value.bytes[0] = EEPROM.read(flashAddress);
-            uint8_stored_value.bytes[1] = 0;
-            uint8_stored_value.bytes[2] = 0;
-            uint8_stored_value.bytes[3] = 0;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? ((crc << 1) ^ 0x07) : (crc << 1);
+        }
+    }
 
-            _registerWriteRegister(type, address, uint8_stored_value.number, false);
-            break;
+    return crc;
+}
 
-        case REGISTER_DATA_TYPE_UINT16:
-            UINT16_UNION_t uint16_stored_value;
+// -----------------------------------------------------------------------------
 
-            uint16_stored_value.bytes[0] = EEPROM.read(flashAddress);
-            uint16_stored_value.bytes[1] = EEPROM.read(flashAddress + 1);
-            uint16_stored_value.bytes[2] = 0;
-            uint16_stored_value.bytes[3] = 0;
+bool _registerJournalReadRecord(
+    const uint8_t slot,
+    uint8_t * record
+) {
+    uint16_t record_address = _registerJournalRecordAddress(slot);
 
-            _registerWriteRegister(type, address, uint16_stored_value.number, false);
-            break;
+    for (uint8_t i = 0; i < REGISTER_JOURNAL_RECORD_SIZE; i++) {
+        record[i] = EEPROM.read(record_address + i);
+    }
 
-        case REGISTER_DATA_TYPE_UINT32:
-            UINT32_UNION_t uint32_stored_value;
+    if (record[2] == 0x00 || record[2] >= FLASH_ADDRESSES_SIZE) {
+        return false;
+    }
 
-            uint32_stored_value.bytes[0] = EEPROM.read(flashAddress);
-            uint32_stored_value.bytes[1] = EEPROM.read(flashAddress + 1);
-            uint32_stored_value.bytes[2] = EEPROM.read(flashAddress + 2);
-            uint32_stored_value.bytes[3] = EEPROM.read(flashAddress + 3);
+    return _registerJournalCrc(record, REGISTER_JOURNAL_RECORD_SIZE - 1) == record[REGISTER_JOURNAL_RECORD_SIZE - 1];
+}
 
-            _registerWriteRegister(type, address, uint32_stored_value.number, false);
-            break;
+// -----------------------------------------------------------------------------
 
-        case REGISTER_DATA_TYPE_INT8:
-            INT8_UNION_t int8_stored_value;
+uint16_t _registerJournalRecordSequence(
+    const uint8_t * record
+) {
+    return (uint16_t) record[1] << 8 | (uint16_t) record[0];
+}
 
-            int8_stored_value.bytes[0] = EEPROM.read(flashAddress);
-            int8_stored_value.bytes[1] = 0;
-            int8_stored_value.bytes[2] = 0;
-            int8_stored_value.bytes[3] = 0;
+// -----------------------------------------------------------------------------
 
-            _registerWriteRegister(type, address, int8_stored_value.number, false);
-            break;
+/**
+ * Sequence is wrapping, newer record is the one which is less than half of range ahead
+ */
+bool _registerJournalIsNewer(
+    const uint16_t sequence,
+    const uint16_t compareTo
+) {
+    return (int16_t) (sequence - compareTo) > 0;
+}
 
-        case REGISTER_DATA_TYPE_INT16:
-            INT16_UNION_t int16_stored_value;
+// -----------------------------------------------------------------------------
 
-            int16_stored_value.bytes[0] = EEPROM.read(flashAddress);
-            int16_stored_value.bytes[1] = EEPROM.read(flashAddress + 1);
-            int16_stored_value.bytes[2] = 0;
-            int16_stored_value.bytes[3] = 0;
+void _registerJournalWriteRecord(
+    const uint8_t slot,
+    const uint8_t key,
+    const uint8_t * value
+) {
+    uint8_t record[REGISTER_JOURNAL_RECORD_SIZE];
 
-            _registerWriteRegister(type, address, int16_stored_value.number, false);
-            break;
+    record[0] = (uint8_t) (_register_journal_sequence & 0xFF);
+    record[1] = (uint8_t) (_register_journal_sequence >> 8);
+    record[2] = key;
 
-        case REGISTER_DATA_TYPE_INT32:
-            INT32_UNION_t int32_stored_value;
+    memcpy(&record[3], value, 4);
 
-            int32_stored_value.bytes[0] = EEPROM.read(flashAddress);
-            int32_stored_value.bytes[1] = EEPROM.read(flashAddress + 1);
-            int32_stored_value.bytes[2] = EEPROM.read(flashAddress + 2);
-            int32_stored_value.bytes[3] = EEPROM.read(flashAddress + 3);
+    record[REGISTER_JOURNAL_RECORD_SIZE - 1] = _registerJournalCrc(record, REGISTER_JOURNAL_RECORD_SIZE - 1);
 
-            _registerWriteRegister(type, address, int32_stored_value.number, false);
-            break;
+    uint16_t record_address = _registerJournalRecordAddress(slot);
 
-        case REGISTER_DATA_TYPE_FLOAT32:
-            FLOAT32_UNION_t float_stored_value;
+    // CRC is written as last, torn record stays invalid
+    for (uint8_t i = 0; i < REGISTER_JOURNAL_RECORD_SIZE; i++) {
+        EEPROM.update(record_address + i, record[i]);
+    }
 
-            float_stored_value.bytes[0] = EEPROM.read(flashAddress);
-            float_stored_value.bytes[1] = EEPROM.read(flashAddress + 1);
-            float_stored_value.bytes[2] = EEPROM.read(flashAddress + 2);
-            float_stored_value.bytes[3] = EEPROM.read(flashAddress + 3);
+    _register_journal_sequence++;
 
-            _registerWriteRegister(type, address, float_stored_value.number, false);
-            break;
+    _register_journal_slots[key] = slot;
 
-        case REGISTER_DATA_TYPE_BUTTON:
-            BUTTON_UNION_t button_stored_value;
+    #if STATS_SUPPORT
+        statsIncrement(STATS_COUNTER_EEPROM_WRITES);
+    #endif
+}
 
-            button_stored_value.bytes[0] = EEPROM.read(flashAddress);
-            button_stored_value.bytes[1] = 0;
-            button_stored_value.bytes[2] = 0;
-            button_stored_value.bytes[3] = 0;
+// -----------------------------------------------------------------------------
 
-            _registerWriteRegister(type, address, button_stored_value.number, false);
-            break;
+/**
+ * Write record into next slot which is not holding newest value of other key
+ */
+void _registerJournalStore(
+    const uint8_t key,
+    const uint8_t * value
+) {
+    uint8_t record[REGISTER_JOURNAL_RECORD_SIZE];
+    uint8_t stale_key = INDEX_NONE;
+
+    for (uint8_t i = 0; i < REGISTER_JOURNAL_RECORDS; i++) {
+        uint8_t slot = _register_journal_head;
+
+        _register_journal_head = (_register_journal_head + 1) % REGISTER_JOURNAL_RECORDS;
+
+        // Newest records are never overwritten, so torn write could not lose stored value
+        if (
+            _registerJournalReadRecord(slot, record)
+            && _register_journal_slots[record[2]] == slot
+        ) {
+            // Live record is kept, but it must not fall out of the sequence window
+            if (
+                record[2] != key
+                && (uint16_t) (_register_journal_sequence - _registerJournalRecordSequence(record)) > REGISTER_JOURNAL_SEQUENCE_REFRESH
+            ) {
+                stale_key = record[2];
+            }
 
-        case REGISTER_DATA_TYPE_SWITCH:
-            SWITCH_UNION_t switch_stored_value;
+            continue;
+        }
 
-            switch_stored_value.bytes[0] = EEPROM.read(flashAddress);
-            switch_stored_value.bytes[1] = 0;
-            switch_stored_value.bytes[2] = 0;
-            switch_stored_value.bytes[3] = 0;
+        _registerJournalWriteRecord(slot, key, value);
 
-            _registerWriteRegister(type, address, switch_stored_value.number, false);
-            break;
+        if (stale_key != INDEX_NONE) {
+            _registerJournalReadRecord(_register_journal_slots[stale_key], record);
 
-        case REGISTER_DATA_TYPE_BOOLEAN:
-            bool bool_memory_value = EEPROM.read(flashAddress);
+            _registerJournalStore(stale_key, &record[3]);
+        }
 
-            _registerWriteRegister(type, address, (bool_memory_value ? REGISTER_BOOLEAN_VALUE_TRUE : REGISTER_BOOLEAN_VALUE_FALSE), false);
-            break;
+        return;
     }
+
+    #if DEBUG_SUPPORT
+        DLOG(LOG_REGISTER_JOURNAL_FULL);
+    #endif
 }
 
 // -----------------------------------------------------------------------------
 
-bool _registerReadRegister(
-    const uint8_t type,
-    const uint8_t address,
-    const uint8_t dataTypeSize,
-    void * value
+/**
+ * Store register value, value same as the newest journal record is not written again
+ */
+void _registerJournalAppend(
+    const uint8_t key,
+    const uint8_t * value
 ) {
-    // Reset to default
-    memset(value, 0, dataTypeSize);
+    if (_register_journal_ready == false || key == 0x00 || key >= FLASH_ADDRESSES_SIZE) {
+        return;
+    }
 
-    if (type == REGISTER_TYPE_INPUT && address < REGISTER_MAX_INPUT_REGISTERS_SIZE) {
-        memcpy(value, register_module_input_registers[address].value, dataTypeSize);
+    if (_register_journal_slots[key] != INDEX_NONE) {
+        uint8_t record[REGISTER_JOURNAL_RECORD_SIZE];
 
-        return true;
+        if (
+            _registerJournalReadRecord(_register_journal_slots[key], record)
+            && memcmp(&record[3], value, 4) == 0
+        ) {
+            return;
+        }
+    }
 
-    } else if (type == REGISTER_TYPE_OUTPUT && address < REGISTER_MAX_OUTPUT_REGISTERS_SIZE) {
-        memcpy(value, register_module_output_registers[address].value, dataTypeSize);
+    _registerJournalStore(key, value);
+}
 
-        return true;
+// -----------------------------------------------------------------------------
 
-    } else if (type == REGISTER_TYPE_ATTRIBUTE && address < REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE) {
-        memcpy(value, register_module_attribute_registers[address].value, dataTypeSize);
+/**
+ * Invalidate all records and write journal header
+ */
+void _registerJournalFormat()
+{
+    for (uint8_t i = 0; i < REGISTER_JOURNAL_RECORDS; i++) {
+        // Record with invalid key is skipped
+        EEPROM.update(_registerJournalRecordAddress(i) + 2, 0xFF);
+    }
 
-        return true;
+    for (uint8_t i = 0; i < REGISTER_JOURNAL_HEADER_SIZE; i++) {
+        EEPROM.update(REGISTER_JOURNAL_START + i, (uint8_t) (REGISTER_JOURNAL_MAGIC >> (8 * (REGISTER_JOURNAL_HEADER_SIZE - 1 - i))));
     }
 
-    return false;
-}
+    memset(_register_journal_slots, INDEX_NONE, FLASH_ADDRESSES_SIZE);
 
-// Specialized convenience setters (these do not cost memory because of inlining)
-bool _registerReadRegister(const uint8_t type, const uint8_t address, uint8_t &value) { return _registerReadRegister(type, address, 1, &value); }
-bool _registerReadRegister(const uint8_t type, const uint8_t address, uint16_t &value) { return _registerReadRegister(type, address, 2, &value); }
-bool _registerReadRegister(const uint8_t type, const uint8_t address, uint32_t &value) { return _registerReadRegister(type, address, 4, &value); }
-bool _registerReadRegister(const uint8_t type, const uint8_t address, int8_t &value) { return _registerReadRegister(type, address, 1, &value); }
-bool _registerReadRegister(const uint8_t type, const uint8_t address, int16_t &value) { return _registerReadRegister(type, address, 2, &value); }
-bool _registerReadRegister(const uint8_t type, const uint8_t address, int32_t &value) { return _registerReadRegister(type, address, 4, &value); }
-bool _registerReadRegister(const uint8_t type, const uint8_t address, float &value) { return _registerReadRegister(type, address, 4, &value); }
+    _register_journal_head = 0;
+    _register_journal_sequence = 0;
+}
 
 // -----------------------------------------------------------------------------
 
-bool _registerReadRegisterAsBytes(
-    const uint8_t type,
-    const uint8_t address,
-    uint8_t * value
-) {
-    uint8_t data_type = registerGetRegisterDataType(type, address);
+bool _registerJournalIsFormatted()
+{
+    for (uint8_t i = 0; i < REGISTER_JOURNAL_HEADER_SIZE; i++) {
+        if (EEPROM.read(REGISTER_JOURNAL_START + i) != (uint8_t) (REGISTER_JOURNAL_MAGIC >> (8 * (REGISTER_JOURNAL_HEADER_SIZE - 1 - i)))) {
+            return false;
+        }
+    }
 
-    switch (data_type)
-    {
-        case REGISTER_DATA_TYPE_UINT8:
-            UINT8_UNION_t uint8_read_value;
+    return true;
+}
 
-            _registerReadRegister(type, address, uint8_read_value.number);
+// -----------------------------------------------------------------------------
 
-            memcpy(value, uint8_read_value.bytes, 1);
+/**
+ * Find newest record for each key & journal head with one linear scan
+ */
+void _registerJournalScan()
+{
+    uint8_t record[REGISTER_JOURNAL_RECORD_SIZE];
+    uint8_t newest_record[REGISTER_JOURNAL_RECORD_SIZE];
 
-            return true;
+    bool is_empty = true;
+    uint16_t newest_sequence = 0;
 
-        case REGISTER_DATA_TYPE_UINT16:
-            UINT16_UNION_t uint16_read_value;
+    memset(_register_journal_slots, INDEX_NONE, FLASH_ADDRESSES_SIZE);
 
-            _registerReadRegister(type, address, uint16_read_value.number);
+    for (uint8_t slot = 0; slot < REGISTER_JOURNAL_RECORDS; slot++) {
+        if (_registerJournalReadRecord(slot, record) == false) {
+            continue;
+        }
 
-            memcpy(value, uint16_read_value.bytes, 2);
+        uint8_t key = record[2];
+        uint16_t sequence = _registerJournalRecordSequence(record);
+
+        if (
+            _register_journal_slots[key] == INDEX_NONE
+            || (
+                _registerJournalReadRecord(_register_journal_slots[key], newest_record)
+                && _registerJournalIsNewer(sequence, _registerJournalRecordSequence(newest_record))
+            )
+        ) {
+            _register_journal_slots[key] = slot;
+        }
 
-            return true;
+        if (is_empty || _registerJournalIsNewer(sequence, newest_sequence)) {
+            newest_sequence = sequence;
 
-        case REGISTER_DATA_TYPE_UINT32:
-            UINT32_UNION_t uint32_read_value;
+            _register_journal_head = (slot + 1) % REGISTER_JOURNAL_RECORDS;
 
-            _registerReadRegister(type, address, uint32_read_value.number);
+            is_empty = false;
+        }
+    }
 
-            memcpy(value, uint32_read_value.bytes, 4);
+    _register_journal_sequence = is_empty ? 0 : newest_sequence + 1;
+}
 
-            return true;
+// -----------------------------------------------------------------------------
 
-        case REGISTER_DATA_TYPE_INT8:
-            INT8_UNION_t int8_read_value;
+void _registerInitializeFromJournal(
+    const uint8_t type,
+    const uint8_t address,
+    const uint8_t flashAddress
+) {
+    uint8_t record[REGISTER_JOURNAL_RECORD_SIZE];
+
+    if (
+        flashAddress >= FLASH_ADDRESSES_SIZE
+        || _register_journal_slots[flashAddress] == INDEX_NONE
+        || _registerJournalReadRecord(_register_journal_slots[flashAddress], record) == false
+    ) {
+        return;
+    }
 
-            _registerReadRegister(type, address, int8_read_value.number);
+    _registerWriteRegister(type, address, 4, &record[3], false);
+}
 
-            memcpy(value, int8_read_value.bytes, 1);
+// -----------------------------------------------------------------------------
+// REGISTERS HELPERS
+// -----------------------------------------------------------------------------
 
-            return true;
+/**
+ * Get index of register value or INDEX_NONE for unknown register
+ */
+uint8_t _registerValueIndex(
+    const uint8_t type,
+    const uint8_t address
+) {
+    if (type > REGISTER_TYPE_ATTRIBUTE || address >= _register_values_size[type]) {
+        return INDEX_NONE;
+    }
 
-        case REGISTER_DATA_TYPE_INT16:
-            INT16_UNION_t int16_read_value;
+    return _register_values_offset[type] + address;
+}
 
-            _registerReadRegister(type, address, int16_read_value.number);
+// -----------------------------------------------------------------------------
 
-            memcpy(value, int16_read_value.bytes, 2);
+/**
+ * Get count of bytes used by data type value in register memory
+ */
+uint8_t _registerDataTypeStorageSize(
+    const uint8_t dataType
+) {
+    // Boolean is kept as 32 bit value
+    return dataType == REGISTER_DATA_TYPE_BOOLEAN ? 4 : deviceDataTypeSize(dataType);
+}
 
-            return true;
+// -----------------------------------------------------------------------------
 
-        case REGISTER_DATA_TYPE_INT32:
-            INT32_UNION_t int32_read_value;
+/**
+ * Erased cells of previous firmware storage are not migrated, register keeps its default value
+ */
+bool _registerLegacyEepromIsErased(
+    const uint8_t type,
+    const uint8_t address,
+    const uint8_t flashAddress
+) {
+    uint8_t data_type_size = registerGetDataTypeSize(registerGetRegisterDataType(type, address));
 
-            _registerReadRegister(type, address, int32_read_value.number);
+    for (uint8_t i = 0; i < data_type_size; i++) {
+        if (EEPROM.read(flashAddress + i) != 0xFF) {
+            return false;
+        }
+    }
 
-            memcpy(value, int32_read_value.bytes, 4);
+    return true;
+}
 
-            return true;
+// -----------------------------------------------------------------------------
 
-        case REGISTER_DATA_TYPE_FLOAT32:
-            FLOAT32_UNION_t float_read_value;
+/**
+ * Values stored by previous firmware at fixed flash addresses, used for migration to journal
+ */
+void _registerInitializeFromLegacyEeprom(
+    const uint8_t type,
+    const uint8_t address,
+    const uint8_t flashAddress
+) {
+    if (_registerLegacyEepromIsErased(type, address, flashAddress)) {
+        return;
+    }
 
-            _registerReadRegister(type, address, float_read_value.number);
+    uint8_t data_type = registerGetRegisterDataType(type, address);
 
-            memcpy(value, float_read_value.bytes, 4);
+    if (data_type == REGISTER_DATA_TYPE_BOOLEAN) {
+        bool bool_memory_value = EEPROM.read(flashAddress);
 
-            return true;
+        _registerWriteRegister(type, address, (bool_memory_value ? REGISTER_BOOLEAN_VALUE_TRUE : REGISTER_BOOLEAN_VALUE_FALSE), false);
 
-        case REGISTER_DATA_TYPE_BUTTON:
-            BOOLEAN_UNION_t button_read_value;
+        return;
+    }
+
+    uint8_t data_type_size = _registerDataTypeStorageSize(data_type);
+    uint8_t stored_value[4] = { 0, 0, 0, 0 };
 
-            _registerReadRegister(type, address, button_read_value.number);
+    for (uint8_t i = 0; i < data_type_size; i++) {
+        stored_value[i] = EEPROM.read(flashAddress + i);
+    }
 
-            memcpy(value, button_read_value.bytes, 1);
+    if (data_type_size > 0) {
+        _registerWriteRegister(type, address, data_type_size, stored_value, false);
+    }
+}
 
-            return true;
+// -----------------------------------------------------------------------------
 
-        case REGISTER_DATA_TYPE_SWITCH:
-            SWITCH_UNION_t switch_read_value;
+bool _registerReadRegister(
+    const uint8_t type,
+    const uint8_t address,
+    const uint8_t dataTypeSize,
+    void * value
+) {
+    // Reset to default
+    memset(value, 0, dataTypeSize);
 
-            _registerReadRegister(type, address, switch_read_value.number);
+    uint8_t index = _registerValueIndex(type, address);
 
-            memcpy(value, switch_read_value.bytes, 1);
+    if (index == INDEX_NONE) {
+        return false;
+    }
 
-            return true;
+    memcpy(value, _register_values[index], dataTypeSize);
 
-        case REGISTER_DATA_TYPE_BOOLEAN:
-            BOOLEAN_UNION_t bool_read_value;
+    return true;
+}
 
-            _registerReadRegister(type, address, bool_read_value.number);
+// Specialized convenience setters (these do not cost memory because of inlining)
+bool _registerReadRegister(const uint8_t type, const uint8_t address, uint8_t &value) { return _registerReadRegister(type, address, 1, &value); }
+bool _registerReadRegister(const uint8_t type, const uint8_t address, uint16_t &value) { return _registerReadRegister(type, address, 2, &value); }
+bool _registerReadRegister(const uint8_t type, const uint8_t address, uint32_t &value) { return _registerReadRegister(type, address, 4, &value); }
+bool _registerReadRegister(const uint8_t type, const uint8_t address, int8_t &value) { return _registerReadRegister(type, address, 1, &value); }
+bool _registerReadRegister(const uint8_t type, const uint8_t address, int16_t &value) { return _registerReadRegister(type, address, 2, &value); }
+bool _registerReadRegister(const uint8_t type, const uint8_t address, int32_t &value) { return _registerReadRegister(type, address, 4, &value); }
+bool _registerReadRegister(const uint8_t type, const uint8_t address, float &value) { return _registerReadRegister(type, address, 4, &value); }
 
-            memcpy(value, bool_read_value.bytes, 4);
+// -----------------------------------------------------------------------------
 
-            return true;
+bool _registerReadRegisterAsBytes(
+    const uint8_t type,
+    const uint8_t address,
+    uint8_t * value
+) {
+    uint8_t data_type_size = _registerDataTypeStorageSize(registerGetRegisterDataType(type, address));
 
-        default:
-            memset(value, 0, 4);
+    if (data_type_size == 0) {
+        memset(value, 0, 4);
 
-            return false;
+        return false;
     }
+
+    return _registerReadRegister(type, address, data_type_size, value);
 }
 
 // -----------------------------------------------------------------------------
@@ -347,13 +482,9 @@ bool _registerWriteRegister(
     const void * value,
     const bool propagate
 ) {
-    if (type == REGISTER_TYPE_INPUT && address >= REGISTER_MAX_INPUT_REGISTERS_SIZE) {
-        return false;
-
-    } else if (type == REGISTER_TYPE_OUTPUT && address >= REGISTER_MAX_OUTPUT_REGISTERS_SIZE) {
-        return false;
+    uint8_t index = _registerValueIndex(type, address);
 
-    } else if (type == REGISTER_TYPE_ATTRIBUTE && address >= REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE) {
+    if (index == INDEX_NONE) {
         return false;
     }
 
@@ -363,26 +494,9 @@ bool _registerWriteRegister(
         return false;
     }
 
-    uint8_t flash_address = INDEX_NONE;
-
-    if (type == REGISTER_TYPE_INPUT) {
-        memcpy(register_module_input_registers[address].value, value, dataTypeSize);
-
-        flash_address = register_module_input_registers[address].flash_address;
+    memcpy(_register_values[index], value, dataTypeSize);
 
-    } else if (type == REGISTER_TYPE_OUTPUT) {
-        memcpy(register_module_output_registers[address].value, value, dataTypeSize);
-
-        flash_address = register_module_output_registers[address].flash_address;
-
-    } else if (type == REGISTER_TYPE_ATTRIBUTE) {
-        memcpy(register_module_attribute_registers[address].value, value, dataTypeSize);
-
-        flash_address = register_module_attribute_registers[address].flash_address;
-
-    } else {
-        return false;
-    }
+    uint8_t flash_address = pgm_read_byte(&device_registers_flash_addresses.items[index]);
 
     if (type == REGISTER_TYPE_ATTRIBUTE) {
         // Special handling for discoverable status
@@ -392,12 +506,11 @@ bool _registerWriteRegister(
         }
     }
 
-    if (memcmp((const void *) old_value, (const void *) value, dataTypeSize) != 0) {
+    bool changed = memcmp((const void *) old_value, (const void *) value, dataTypeSize) != 0;
+
+    if (changed) {
         #if DEBUG_SUPPORT
-            DPRINT(F("[REGISTER] Value was written into: "));
-            DPRINT(type);
-            DPRINT(F(" register at address "));
-            DPRINTLN(address);
+            DLOG(LOG_REGISTER_WRITTEN, type, address);
         #endif
 
         if (flash_address != INDEX_NONE) {
@@ -405,38 +518,21 @@ bool _registerWriteRegister(
 
             if (_registerReadRegisterAsBytes(type, address, stored_value) == true) {
                 // Store value in memory
-                _registerWriteToEeprom(type, address, flash_address, stored_value);                        
-            }
-        }
-
-        if (type == REGISTER_TYPE_ATTRIBUTE) {
-            // Special handling for communication address stored in registry
-            if (address == COMMUNICATION_ATTR_REGISTER_ADDR_ADDRESS && firmwareIsBooting() == false) {
-                uint8_t device_address;
-
-                _registerReadRegister(REGISTER_TYPE_ATTRIBUTE, COMMUNICATION_ATTR_REGISTER_ADDR_ADDRESS, device_address);
-
-                // Update communication address
-                communicationSetAddress(device_address);
-
-                // ...after address is stored, reload device
-                firmwareSetReboot();
+                _registerJournalAppend(flash_address, stored_value);
             }
         }
-
-        if (propagate) {
-            communicationReportRegister(type, address);
-        }
     #if DEBUG_SUPPORT
     } else {
-        DPRINT(F("[REGISTER] Value to write into: "));
-        DPRINT(type);
-        DPRINT(F(" register at address "));
-        DPRINT(address);
-        DPRINTLN(F(" is same as stored. Write skipped"));
+        DLOG(LOG_REGISTER_WRITE_SKIPPED, type, address);
     #endif
     }
 
+    _registerNotifyObservers(type, address, changed);
+
+    if (changed && propagate) {
+        communicationReportRegister(type, address);
+    }
+
     return true;
 }
 
@@ -458,157 +554,210 @@ bool _registerWriteRegisterFromBytes(
     uint8_t * value,
     const bool propagate
 ) {
-    uint8_t data_type = registerGetRegisterDataType(type, address);
-
-    switch (data_type)
-    {
-        case REGISTER_DATA_TYPE_UINT8:
-            UINT8_UNION_t uint8_write_value;
-
-            uint8_write_value.bytes[0] = value[0];
-            uint8_write_value.bytes[1] = 0;
-            uint8_write_value.bytes[2] = 0;
-            uint8_write_value.bytes[3] = 0;
-
-            _registerWriteRegister(type, address, uint8_write_value.number, propagate);
-
-            return true;
+    uint8_t data_type_size = _registerDataTypeStorageSize(registerGetRegisterDataType(type, address));
 
-        case REGISTER_DATA_TYPE_UINT16:
-            UINT16_UNION_t uint16_write_value;
-
-            uint16_write_value.bytes[0] = value[0];
-            uint16_write_value.bytes[1] = value[1];
-            uint16_write_value.bytes[2] = 0;
-            uint16_write_value.bytes[3] = 0;
-
-            _registerWriteRegister(type, address, uint16_write_value.number, propagate);
-
-            return true;
+    if (data_type_size == 0) {
+        return false;
+    }
 
-        case REGISTER_DATA_TYPE_UINT32:
-            UINT32_UNION_t uint32_write_value;
+    uint8_t write_value[4] = { 0, 0, 0, 0 };
 
-            uint32_write_value.bytes[0] = value[0];
-            uint32_write_value.bytes[1] = value[1];
-            uint32_write_value.bytes[2] = value[2];
-            uint32_write_value.bytes[3] = value[3];
+    memcpy(write_value, value, data_type_size);
 
-            _registerWriteRegister(type, address, uint32_write_value.number, propagate);
+    _registerWriteRegister(type, address, data_type_size, write_value, propagate);
 
-            return true;
+    return true;
+}
 
-        case REGISTER_DATA_TYPE_INT8:
-            INT8_UNION_t int8_write_value;
+// -----------------------------------------------------------------------------
 
-            int8_write_value.bytes[0] = value[0];
-            int8_write_value.bytes[1] = 0;
-            int8_write_value.bytes[2] = 0;
-            int8_write_value.bytes[3] = 0;
+void _registerNotifyObservers(
+    const uint8_t type,
+    const uint8_t address,
+    const bool changed
+) {
+    for (uint8_t i = 0; i < _register_observers_count; i++) {
+        if (
+            (changed || _register_observers[i].every_write)
+            && _register_observers[i].register_type == type
+            && address >= _register_observers[i].register_address
+            && address < (_register_observers[i].register_address + _register_observers[i].registers_count)
+        ) {
+            _register_observers[i].callback(type, address);
+        }
+    }
+}
 
-            _registerWriteRegister(type, address, int8_write_value.number, propagate);
+// -----------------------------------------------------------------------------
+// MODULE API
+// -----------------------------------------------------------------------------
 
-            return true;
+/**
+ * Watch registers range for values changes, callback is invoked when written value is same as stored only for every write observer
+ */
+bool registerAddObserver(
+    const uint8_t type,
+    const uint8_t address,
+    const uint8_t count,
+    register_observer_callback_t callback,
+    const bool everyWrite
+) {
+    if (
+        callback == NULL
+        || count == 0
+        || ((uint16_t) address + count) > registerGetRegistersSize(type)
+    ) {
+        return false;
+    }
 
-        case REGISTER_DATA_TYPE_INT16:
-            INT16_UNION_t int16_write_value;
+    if (_register_observers_count >= REGISTER_OBSERVERS_SIZE) {
+        #if DEBUG_SUPPORT
+            DLOG(LOG_REGISTER_OBSERVER_NOT_ADDED, count, address);
+        #endif
 
-            int16_write_value.bytes[0] = value[0];
-            int16_write_value.bytes[1] = value[1];
-            int16_write_value.bytes[2] = 0;
-            int16_write_value.bytes[3] = 0;
+        return false;
+    }
 
-            _registerWriteRegister(type, address, int16_write_value.number, propagate);
+    _register_observers[_register_observers_count].register_type = type;
+    _register_observers[_register_observers_count].register_address = address;
+    _register_observers[_register_observers_count].registers_count = count;
+    _register_observers[_register_observers_count].every_write = everyWrite;
+    _register_observers[_register_observers_count].callback = callback;
 
-            return true;
+    _register_observers_count++;
 
-        case REGISTER_DATA_TYPE_INT32:
-            INT32_UNION_t int32_write_value;
+    return true;
+}
 
-            int32_write_value.bytes[0] = value[0];
-            int32_write_value.bytes[1] = value[1];
-            int32_write_value.bytes[2] = value[2];
-            int32_write_value.bytes[3] = value[3];
+// -----------------------------------------------------------------------------
 
-            _registerWriteRegister(type, address, int32_write_value.number, propagate);
+/**
+ * Get register configured data type
+ */
+uint8_t registerGetRegisterDataType(
+    const uint8_t type,
+    const uint8_t address
+) {
+    uint8_t index = _registerValueIndex(type, address);
 
-            return true;
+    if (index == INDEX_NONE) {
+        return REGISTER_DATA_TYPE_UNKNOWN;
+    }
 
-        case REGISTER_DATA_TYPE_FLOAT32:
-            FLOAT32_UNION_t float_write_value;
+    return pgm_read_byte(&device_registers_data_types.items[index]);
+}
 
-            float_write_value.bytes[0] = value[0];
-            float_write_value.bytes[1] = value[1];
-            float_write_value.bytes[2] = value[2];
-            float_write_value.bytes[3] = value[3];
+// -----------------------------------------------------------------------------
 
-            _registerWriteRegister(type, address, float_write_value.number, propagate);
+/**
+ * Copy data types of registers range into buffer, data types are stored in flash
+ * one after another so whole range is copied at once
+ *
+ * @return Count of copied data types
+ */
+uint8_t registerReadRegistersDataTypes(
+    const uint8_t type,
+    const uint8_t address,
+    const uint8_t count,
+    uint8_t * buffer
+) {
+    uint8_t index = _registerValueIndex(type, address);
 
-            return true;
+    if (index == INDEX_NONE) {
+        return 0;
+    }
 
-        case REGISTER_DATA_TYPE_BUTTON:
-            BOOLEAN_UNION_t button_write_value;
+    uint8_t length = count;
 
-            button_write_value.bytes[0] = value[0];
-            button_write_value.bytes[1] = 0;
-            button_write_value.bytes[2] = 0;
-            button_write_value.bytes[3] = 0;
+    if ((address + length) > _register_values_size[type]) {
+        length = _register_values_size[type] - address;
+    }
 
-            _registerWriteRegister(type, address, button_write_value.number, propagate);
+    memcpy_P(buffer, &device_registers_data_types.items[index], length);
 
-            return true;
+    return length;
+}
 
-        case REGISTER_DATA_TYPE_SWITCH:
-            SWITCH_UNION_t switch_write_value;
+// -----------------------------------------------------------------------------
 
-            switch_write_value.bytes[0] = value[0];
-            switch_write_value.bytes[1] = 0;
-            switch_write_value.bytes[2] = 0;
-            switch_write_value.bytes[3] = 0;
+/**
+ * Get count of bytes used by data type value when transferred
+ */
+uint8_t registerGetDataTypeSize(
+    const uint8_t dataType
+) {
+    return deviceDataTypeSize(dataType);
+}
 
-            _registerWriteRegister(type, address, switch_write_value.number, propagate);
+// -----------------------------------------------------------------------------
 
-            return true;
+/**
+ * Get count of registers of given type
+ */
+uint8_t registerGetRegistersSize(
+    const uint8_t type
+) {
+    if (type > REGISTER_TYPE_ATTRIBUTE) {
+        return 0;
+    }
 
-        case REGISTER_DATA_TYPE_BOOLEAN:
-            BOOLEAN_UNION_t bool_write_value;
+    return _register_values_size[type];
+}
 
-            bool_write_value.bytes[0] = value[0];
-            bool_write_value.bytes[1] = value[1];
-            bool_write_value.bytes[2] = value[2];
-            bool_write_value.bytes[3] = value[3];
+// -----------------------------------------------------------------------------
 
-            _registerWriteRegister(type, address, bool_write_value.number, propagate);
+/**
+ * Check if attribute register could be written by master
+ */
+bool registerIsAttributeSettable(
+    const uint8_t address
+) {
+    #if REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
+        return address < REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE && pgm_read_byte(&register_module_attribute_registers[address].settable);
+    #else
+        return false;
+    #endif
+}
 
-            return true;
+// -----------------------------------------------------------------------------
 
-        default:
-            return false;
-    }
+/**
+ * Check if attribute register could be read by master
+ */
+bool registerIsAttributeQueryable(
+    const uint8_t address
+) {
+    #if REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
+        return address < REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE && pgm_read_byte(&register_module_attribute_registers[address].queryable);
+    #else
+        return false;
+    #endif
 }
 
-// -----------------------------------------------------------------------------
-// MODULE API
 // -----------------------------------------------------------------------------
 
 /**
- * Get register configured data type
+ * Copy attribute register name without terminator into buffer
+ *
+ * @return Length of name
  */
-uint8_t registerGetRegisterDataType(
-    const uint8_t type,
-    const uint8_t address
+uint8_t registerReadAttributeName(
+    const uint8_t address,
+    char * name
 ) {
-    if (type == REGISTER_TYPE_INPUT && address < REGISTER_MAX_INPUT_REGISTERS_SIZE) {
-        return register_module_input_registers[address].data_type;
+    #if REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
+        if (address >= REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE) {
+            return 0;
+        }
 
-    } else if (type == REGISTER_TYPE_OUTPUT && address < REGISTER_MAX_OUTPUT_REGISTERS_SIZE) {
-        return register_module_output_registers[address].data_type;
+        uint8_t length = strlen_P(register_module_attribute_registers[address].name);
 
-    } else if (type == REGISTER_TYPE_ATTRIBUTE && address < REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE) {
-        return register_module_attribute_registers[address].data_type;
-    }
+        memcpy_P(name, register_module_attribute_registers[address].name, length);
 
-    return REGISTER_DATA_TYPE_UNKNOWN;
+        return length;
+    #else
+        return 0;
+    #endif
 }
 
 // -----------------------------------------------------------------------------
@@ -664,33 +813,140 @@ bool registerWriteRegister(const uint8_t type, const uint8_t address, const bool
 // Specialized for transforming from bytes
 bool registerWriteRegister(const uint8_t type, const uint8_t address, uint8_t * value) { return _registerWriteRegisterFromBytes(type, address, value, true); }
 
+// -----------------------------------------------------------------------------
+
+/**
+ * Store value of UINT32 register without logging, persisting or passing it to observers
+ * Intended for frequently refreshed values, e.g. runtime stats, changed value is reported only to subscribed master
+ */
+bool registerStoreRegister(
+    const uint8_t type,
+    const uint8_t address,
+    const uint32_t value
+) {
+    uint8_t index = _registerValueIndex(type, address);
+
+    if (index == INDEX_NONE || pgm_read_byte(&device_registers_data_types.items[index]) != REGISTER_DATA_TYPE_UINT32) {
+        return false;
+    }
+
+    if (memcmp((const void *) _register_values[index], (const void *) &value, 4) != 0) {
+        memcpy(_register_values[index], &value, 4);
+
+        communicationReportSubscribedRegister(type, address);
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Drop all stored registers values, registers will boot with default values
+ */
+void registerClearStorage()
+{
+    _registerJournalFormat();
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Write all pending changes into persistent storage, e.g. before device restart
+ */
+void registerCommitStorage()
+{
+    #if defined(ARDUINO_ARCH_SAM) || defined(ARDUINO_ARCH_SAMD) || defined(ARDUINO_ARCH_STM32F2)
+        EEPROM.commit();
+    #endif
+}
+
 // -----------------------------------------------------------------------------
 // MODULE CORE
 // -----------------------------------------------------------------------------
 
 void registerSetup()
 {
-    #if REGISTER_MAX_INPUT_REGISTERS_SIZE
-        for(int i = 0; i < REGISTER_MAX_INPUT_REGISTERS_SIZE; ++i) {
-            if (register_module_input_registers[i].flash_address != INDEX_NONE) {
-                _registerInitializeFromEeprom(REGISTER_TYPE_INPUT, i, register_module_input_registers[i].flash_address);
-            }
+    #if defined(ARDUINO_ARCH_SAM) || defined(ARDUINO_ARCH_SAMD) || defined(ARDUINO_ARCH_STM32F2)
+        // Load emulated EEPROM content from flash
+        EEPROM.init();
+    #endif
+
+    // Modules are adding their observers in their setup
+    _register_observers_count = 0;
+
+    #if REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
+        for (uint8_t i = 0; i < REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE; i++) {
+            memcpy_P(_register_values[_register_values_offset[REGISTER_TYPE_ATTRIBUTE] + i], register_module_attribute_registers[i].default_value, 4);
         }
     #endif
 
-    #if REGISTER_MAX_OUTPUT_REGISTERS_SIZE
-        for(int i = 0; i < REGISTER_MAX_OUTPUT_REGISTERS_SIZE; ++i) {
-            if (register_module_output_registers[i].flash_address != INDEX_NONE) {
-                _registerInitializeFromEeprom(REGISTER_TYPE_OUTPUT, i, register_module_output_registers[i].flash_address);
+    bool is_formatted = _registerJournalIsFormatted();
+
+    if (is_formatted) {
+        _registerJournalScan();
+
+        _register_journal_ready = true;
+
+    #if DEBUG_SUPPORT
+    } else {
+        DLOG(LOG_REGISTER_JOURNAL_MIGRATION);
+    #endif
+    }
+
+    // Values of previous firmware are loaded from fixed addresses first, journal is overwriting them
+    for (uint8_t type = REGISTER_TYPE_INPUT; type <= REGISTER_TYPE_ATTRIBUTE; type++) {
+        for (uint8_t address = 0; address < _register_values_size[type]; address++) {
+            uint8_t flash_address = pgm_read_byte(&device_registers_flash_addresses.items[_register_values_offset[type] + address]);
+
+            if (flash_address == INDEX_NONE) {
+                continue;
+            }
+
+            if (is_formatted) {
+                _registerInitializeFromJournal(type, address, flash_address);
+
+            } else {
+                _registerInitializeFromLegacyEeprom(type, address, flash_address);
             }
         }
-    #endif
+    }
 
-    #if REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE
-        for(int i = 0; i < REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE; ++i) {
-            if (register_module_attribute_registers[i].flash_address != INDEX_NONE) {
-                _registerInitializeFromEeprom(REGISTER_TYPE_ATTRIBUTE, i, register_module_attribute_registers[i].flash_address);
+    if (is_formatted) {
+        return;
+    }
+
+    _registerJournalFormat();
+
+    _register_journal_ready = true;
+
+    uint8_t stored_value[4] = { 0, 0, 0, 0 };
+
+    for (uint8_t type = REGISTER_TYPE_INPUT; type <= REGISTER_TYPE_ATTRIBUTE; type++) {
+        for (uint8_t address = 0; address < _register_values_size[type]; address++) {
+            uint8_t flash_address = pgm_read_byte(&device_registers_flash_addresses.items[_register_values_offset[type] + address]);
+
+            if (flash_address != INDEX_NONE && _registerReadRegisterAsBytes(type, address, stored_value)) {
+                _registerJournalAppend(flash_address, stored_value);
             }
         }
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void registerLoop()
+{
+    #if defined(ARDUINO_ARCH_SAM) || defined(ARDUINO_ARCH_SAMD) || defined(ARDUINO_ARCH_STM32F2)
+        // Emulated EEPROM is kept in RAM, changed rows are written into flash after quiet period
+        if (EEPROM.commitDeferred(REGISTER_STORAGE_COMMIT_DELAY)) {
+            #if STATS_SUPPORT
+                statsIncrement(STATS_COUNTER_FLASH_COMMITS);
+            #endif
+
+            #if DEBUG_SUPPORT
+                DLOG(LOG_REGISTER_FLASH_COMMITTED);
+            #endif
+        }
     #endif
 }
@@ -12,12 +12,188 @@ Copyright (C) 2018 FastyBird s.r.o. <code@fastybird.com>
 
 #include <Arduino.h>
 
+#if RELAY_MAX_ITEMS > 16
+    #error "Relay module supports up to 16 relays"
+#endif
+
 bool _relayRecursive = false;
 
+// Relays which register was written by master and waits for processing
+uint16_t _relay_register_pending = 0;
+
+bool _relay_register_writing = false;   // Output register is written by relay module itself
+
+// Hierarchical timer wheel, each slot holds mask of relays which deadline falls into it
+uint16_t _relay_timer_wheel[RELAY_TIMER_WHEEL_LEVELS][RELAY_TIMER_WHEEL_SLOTS];
+
+uint16_t _relay_timer_armed = 0;
+uint16_t _relay_timer_expired = 0;
+
+uint32_t _relay_timer_tick = 0;
+uint32_t _relay_timer_time = 0;         // Time of the last processed tick
+
+#if RELAY_PROVIDER == RELAY_PROVIDER_RELAY
+    // Latched relays coil pulses, pulses started together share one pulse window
+    uint16_t _relay_latch_waiting = 0;  // Relays waiting for coil pulse
+    uint16_t _relay_latch_pulsing = 0;  // Relays with coil pulse in progress
+    uint16_t _relay_latch_state = 0;    // Last status set by coil pulse
+
+    unsigned long _relay_latch_start = 0;
+#endif
+
+// -----------------------------------------------------------------------------
+// TIMER WHEEL
+// -----------------------------------------------------------------------------
+
+/**
+ * Place relay into wheel slot according to its deadline
+ * Deadlines beyond the last level are parked in its farthest slot and placed again when cascaded
+ */
+void _relayTimerInsert(
+    const uint8_t id
+) {
+    // Deadline which already passed is processed without waiting for next tick
+    if ((int32_t) (relay_module_items[id].change_time - millis()) <= 0) {
+        _relay_timer_expired |= (1U << id);
+
+        return;
+    }
+
+    uint32_t remaining = relay_module_items[id].change_time - _relay_timer_time;
+    uint32_t ticks = (remaining + RELAY_TIMER_WHEEL_TICK - 1) >> RELAY_TIMER_WHEEL_TICK_SHIFT;
+
+    uint8_t level = 0;
+
+    while (level < (RELAY_TIMER_WHEEL_LEVELS - 1) && ticks >= (1UL << (RELAY_TIMER_WHEEL_SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+
+    if (ticks >= (1UL << (RELAY_TIMER_WHEEL_SLOT_BITS * RELAY_TIMER_WHEEL_LEVELS))) {
+        ticks = (1UL << (RELAY_TIMER_WHEEL_SLOT_BITS * RELAY_TIMER_WHEEL_LEVELS)) - 1;
+    }
+
+    uint8_t slot = ((_relay_timer_tick + ticks) >> (RELAY_TIMER_WHEEL_SLOT_BITS * level)) & (RELAY_TIMER_WHEEL_SLOTS - 1);
+
+    _relay_timer_wheel[level][slot] |= (1U << id);
+}
+
+// -----------------------------------------------------------------------------
+
+void _relayTimerCancel(
+    const uint8_t id
+) {
+    uint16_t mask = ~(1U << id);
+
+    if ((_relay_timer_armed & ~mask) == 0) {
+        return;
+    }
+
+    for (uint8_t level = 0; level < RELAY_TIMER_WHEEL_LEVELS; level++) {
+        for (uint8_t slot = 0; slot < RELAY_TIMER_WHEEL_SLOTS; slot++) {
+            _relay_timer_wheel[level][slot] &= mask;
+        }
+    }
+
+    _relay_timer_expired &= mask;
+    _relay_timer_armed &= mask;
+}
+
+// -----------------------------------------------------------------------------
+
+void _relayTimerSchedule(
+    const uint8_t id,
+    const unsigned long deadline
+) {
+    _relayTimerCancel(id);
+
+    relay_module_items[id].change_time = deadline;
+
+    _relay_timer_armed |= (1U << id);
+
+    _relayTimerInsert(id);
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Move relays from higher level slot to lower levels
+ */
+void _relayTimerCascade(
+    const uint8_t level,
+    const uint8_t slot
+) {
+    uint16_t relays = _relay_timer_wheel[level][slot];
+
+    _relay_timer_wheel[level][slot] = 0;
+
+    for (uint8_t id = 0; relays != 0; id++, relays >>= 1) {
+        if (relays & 1) {
+            _relayTimerInsert(id);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Advance wheel to current time and collect relays with expired deadline
+ */
+void _relayTimerAdvance()
+{
+    uint32_t elapsed = millis() - _relay_timer_time;
+
+    // Empty wheel could be moved forward without walking the slots
+    if (_relay_timer_armed == 0) {
+        _relay_timer_tick += elapsed >> RELAY_TIMER_WHEEL_TICK_SHIFT;
+        _relay_timer_time += elapsed & ~(RELAY_TIMER_WHEEL_TICK - 1);
+
+        return;
+    }
+
+    while (elapsed >= RELAY_TIMER_WHEEL_TICK) {
+        elapsed -= RELAY_TIMER_WHEEL_TICK;
+
+        _relay_timer_time += RELAY_TIMER_WHEEL_TICK;
+        _relay_timer_tick++;
+
+        uint32_t tick = _relay_timer_tick;
+
+        // Whole rotation of lower level was passed, next slot of higher level is due
+        for (uint8_t level = 1; level < RELAY_TIMER_WHEEL_LEVELS && (tick & (RELAY_TIMER_WHEEL_SLOTS - 1)) == 0; level++) {
+            tick >>= RELAY_TIMER_WHEEL_SLOT_BITS;
+
+            _relayTimerCascade(level, tick & (RELAY_TIMER_WHEEL_SLOTS - 1));
+        }
+
+        uint8_t slot = _relay_timer_tick & (RELAY_TIMER_WHEEL_SLOTS - 1);
+
+        _relay_timer_expired |= _relay_timer_wheel[0][slot];
+        _relay_timer_wheel[0][slot] = 0;
+    }
+}
+
 // -----------------------------------------------------------------------------
 // MODULE PRIVATE
 // -----------------------------------------------------------------------------
 
+/**
+ * Check if relay switched into given status have to be switched back after pulse time
+ */
+bool _relayIsPulse(
+    const bool status
+) {
+    if (RELAY_PULSE_MODE == RELAY_PULSE_OFF) {
+        return status;
+
+    } else if (RELAY_PULSE_MODE == RELAY_PULSE_ON) {
+        return !status;
+    }
+
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+
 void _relayConfigure()
 {
     for (uint8_t i = 0; i < RELAY_MAX_ITEMS; i++) {
@@ -34,6 +210,14 @@ void _relayConfigure()
         if (relay_module_items[i].type == RELAY_TYPE_INVERSE) {
             // Set to high to block short opening of relay
             digitalWrite(relay_module_items[i].pin, HIGH);
+
+        } else if (relay_module_items[i].type == RELAY_TYPE_LATCHED_INVERSE) {
+            // Coils of inverse latched relay are idle in high level
+            digitalWrite(relay_module_items[i].pin, HIGH);
+
+            if (relay_module_items[i].reset_pin != GPIO_NONE) {
+                digitalWrite(relay_module_items[i].reset_pin, HIGH);
+            }
         }
     }
 }
@@ -53,10 +237,7 @@ void _relayBoot()
         registerReadRegister(REGISTER_TYPE_OUTPUT, relay_module_items[i].register_address, stored_state);
 
         #if DEBUG_SUPPORT
-            DPRINT(F("[RELAY] Relay #"));
-            DPRINT(i);
-            DPRINT(F(" stored state "));
-            DPRINTLN(stored_state);
+            DLOG(LOG_RELAY_STORED_STATE, i, stored_state);
         #endif
 
         status = false;
@@ -78,7 +259,17 @@ void _relayBoot()
         relay_module_items[i].current_status = !status;
         relay_module_items[i].target_status = status;
 
-        relay_module_items[i].change_time = millis();
+        #if RELAY_PROVIDER == RELAY_PROVIDER_RELAY
+            // Physical state of latched relay is unknown, coil is pulsed on boot
+            if (status) {
+                _relay_latch_state &= ~(1U << i);
+
+            } else {
+                _relay_latch_state |= (1U << i);
+            }
+        #endif
+
+        _relayTimerSchedule(i, millis());
 
         #if REGISTER_MAX_OUTPUT_REGISTERS_SIZE
             // Store state into communication register
@@ -115,75 +306,208 @@ void _relayProviderStatus(
             digitalWrite(relay_module_items[id].pin, !status);
 
         } else if (relay_module_items[id].type == RELAY_TYPE_LATCHED || relay_module_items[id].type == RELAY_TYPE_LATCHED_INVERSE) {
-            bool pulse = RELAY_TYPE_LATCHED ? HIGH : LOW;
-
-            digitalWrite(relay_module_items[id].pin, !pulse);
+            // Coil pulse is driven from loop
+            _relay_latch_waiting |= (1U << id);
+        }
+    #endif
+}
 
-            if (relay_module_items[id].reset_pin != GPIO_NONE) {
-                digitalWrite(relay_module_items[id].reset_pin, !pulse);
-            }
+#if RELAY_PROVIDER == RELAY_PROVIDER_RELAY
 
-            if (status || (relay_module_items[id].reset_pin == GPIO_NONE)) {
-                digitalWrite(relay_module_items[id].pin, pulse);
+// -----------------------------------------------------------------------------
 
-            } else {
-                digitalWrite(relay_module_items[id].reset_pin, pulse);
-            }
+/**
+ * Coil pulse level, inverse latched relay is pulsed by low level
+ */
+bool _relayLatchPulseLevel(
+    const uint8_t id
+) {
+    return relay_module_items[id].type == RELAY_TYPE_LATCHED ? HIGH : LOW;
+}
 
-            niceDelay(RELAY_LATCHING_PULSE);
+// -----------------------------------------------------------------------------
 
-            digitalWrite(relay_module_items[id].pin, !pulse);
+/**
+ * Check if relay shares set or reset pin with any of given relays
+ */
+bool _relayLatchSharesPin(
+    const uint8_t id,
+    uint16_t relays
+) {
+    for (uint8_t i = 0; relays != 0; i++, relays >>= 1) {
+        if ((relays & 1) == 0) {
+            continue;
+        }
 
-            if (relay_module_items[id].reset_pin != GPIO_NONE) {
-                digitalWrite(relay_module_items[id].reset_pin, !pulse);
-            }
+        if (
+            relay_module_items[id].pin == relay_module_items[i].pin
+            || relay_module_items[id].pin == relay_module_items[i].reset_pin
+            || (
+                relay_module_items[id].reset_pin != GPIO_NONE
+                && (relay_module_items[id].reset_pin == relay_module_items[i].pin || relay_module_items[id].reset_pin == relay_module_items[i].reset_pin)
+            )
+        ) {
+            return true;
         }
-    #endif
+    }
+
+    return false;
 }
 
 // -----------------------------------------------------------------------------
 
 /**
- * Walks the relay vector processing only those relays
- * that have to change to the requested mode
- * @bool mode Requested mode
+ * Latched relays state machine
+ * Waiting relays are pulsed together, relays sharing a pin with a pulsing relay wait for next window
  */
-void _relayProcess(
-    const bool mode
-) {
-    unsigned long current_time = millis();
+void _relayLatchLoop()
+{
+    if (_relay_latch_pulsing != 0) {
+        if ((millis() - _relay_latch_start) < RELAY_LATCHING_PULSE) {
+            return;
+        }
 
-    for (uint8_t id = 0; id < RELAY_MAX_ITEMS; id++) {
-        // Only process the relays we have to change
-        if (relay_module_items[id].target_status == relay_module_items[id].current_status) {
+        uint16_t relays = _relay_latch_pulsing;
+
+        for (uint8_t id = 0; relays != 0; id++, relays >>= 1) {
+            if ((relays & 1) == 0) {
+                continue;
+            }
+
+            digitalWrite(relay_module_items[id].pin, !_relayLatchPulseLevel(id));
+
+            if (relay_module_items[id].reset_pin != GPIO_NONE) {
+                digitalWrite(relay_module_items[id].reset_pin, !_relayLatchPulseLevel(id));
+            }
+        }
+
+        _relay_latch_pulsing = 0;
+    }
+
+    if (_relay_latch_waiting == 0) {
+        return;
+    }
+
+    uint16_t relays = _relay_latch_waiting;
+
+    for (uint8_t id = 0; relays != 0; id++, relays >>= 1) {
+        if ((relays & 1) == 0) {
             continue;
         }
 
-        // Only process the relays we have to change to the requested mode
-        if (relay_module_items[id].target_status != mode) {
+        bool status = relay_module_items[id].current_status;
+
+        // Relay is already in requested state, e.g. it was switched back before its pulse
+        if (((_relay_latch_state >> id) & 1) == status) {
+            _relay_latch_waiting &= ~(1U << id);
+
             continue;
         }
 
-        // Only process if the change_time has arrived
-        if (current_time < relay_module_items[id].change_time) {
+        if (_relayLatchSharesPin(id, _relay_latch_pulsing)) {
             continue;
         }
 
-        #if DEBUG_SUPPORT
-            DPRINT(F("[RELAY] #"));
-            DPRINT(id);
-            DPRINT(F(" set to "));
-            DPRINTLN(relay_module_items[id].target_status ? F("ON") : F("OFF"));
-        #endif
+        // Relay without reset pin toggles its state with each pulse
+        if (status || relay_module_items[id].reset_pin == GPIO_NONE) {
+            digitalWrite(relay_module_items[id].pin, _relayLatchPulseLevel(id));
 
-        // Call the provider to perform the action
-        _relayProviderStatus(id, relay_module_items[id].target_status);
+        } else {
+            digitalWrite(relay_module_items[id].reset_pin, _relayLatchPulseLevel(id));
+        }
 
-        #if REGISTER_MAX_OUTPUT_REGISTERS_SIZE
-            // Store state into communication register
-            registerWriteRegister(REGISTER_TYPE_OUTPUT, relay_module_items[id].register_address, relay_module_items[id].target_status ? RELAY_TURN_ON : RELAY_TURN_OFF);
-        #endif
+        if (status) {
+            _relay_latch_state |= (1U << id);
+
+        } else {
+            _relay_latch_state &= ~(1U << id);
+        }
+
+        _relay_latch_waiting &= ~(1U << id);
+        _relay_latch_pulsing |= (1U << id);
+    }
+
+    if (_relay_latch_pulsing != 0) {
+        _relay_latch_start = millis();
+    }
+}
+
+#endif // RELAY_PROVIDER == RELAY_PROVIDER_RELAY
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Perform scheduled change of relay which deadline has expired
+ * @uint8_t id Relay identifier
+ */
+void _relayProcess(
+    const uint8_t id
+) {
+    // Scheduled change was cancelled in the meantime
+    if (relay_module_items[id].target_status == relay_module_items[id].current_status) {
+        return;
+    }
+
+    #if DEBUG_SUPPORT
+        DLOG(LOG_RELAY_SET, id, relay_module_items[id].target_status);
+    #endif
+
+    // Call the provider to perform the action
+    _relayProviderStatus(id, relay_module_items[id].target_status);
+
+    #if REGISTER_MAX_OUTPUT_REGISTERS_SIZE
+        // Store state into communication register
+        _relay_register_writing = true;
+
+        registerWriteRegister(REGISTER_TYPE_OUTPUT, relay_module_items[id].register_address, relay_module_items[id].target_status ? RELAY_TURN_ON : RELAY_TURN_OFF);
+
+        _relay_register_writing = false;
+    #endif
+
+    // Relay in pulse mode is switched back after pulse time
+    if (_relayIsPulse(relay_module_items[id].current_status)) {
+        relay_module_items[id].target_status = !relay_module_items[id].current_status;
+
+        _relayTimerSchedule(id, millis() + (unsigned long) (1000 * RELAY_PULSE_TIME));
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void _relayProcessMultiple(
+    uint16_t relays
+) {
+    for (uint8_t id = 0; relays != 0; id++, relays >>= 1) {
+        if (relays & 1) {
+            _relayProcess(id);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Perform changes of all relays which deadline has expired
+ */
+void _relayProcessExpired()
+{
+    uint16_t expired = _relay_timer_expired;
+
+    _relay_timer_expired = 0;
+    _relay_timer_armed &= ~expired;
+
+    uint16_t relays = expired;
+    uint16_t turning_on = 0;
+
+    for (uint8_t id = 0; relays != 0; id++, relays >>= 1) {
+        if ((relays & 1) && relay_module_items[id].target_status) {
+            turning_on |= (1U << id);
+        }
     }
+
+    // Relays which are turning off are processed first
+    _relayProcessMultiple(expired & ~turning_on);
+    _relayProcessMultiple(turning_on);
 }
 
 // -----------------------------------------------------------------------------
@@ -219,26 +543,33 @@ bool relayStatus(
     if (relay_module_items[id].current_status == set_status) {
         if (relay_module_items[id].target_status != set_status) {
             #if DEBUG_SUPPORT
-                DPRINT(F("[RELAY] #"));
-                DPRINT(id);
-                DPRINT(F(" scheduled change cancelled\n"));
+                DLOG(LOG_RELAY_CHANGE_CANCELLED, id);
             #endif
 
             relay_module_items[id].target_status = set_status;
 
+            _relayTimerCancel(id);
+
             changed = true;
         }
 
+        // Repeated request restarts the pulse, e.g. staircase light is kept on
+        if (_relayIsPulse(set_status)) {
+            relay_module_items[id].target_status = !set_status;
+
+            _relayTimerSchedule(id, millis() + (unsigned long) (1000 * RELAY_PULSE_TIME));
+        }
+
     } else {
         unsigned long current_time = millis();
-        unsigned long fw_end = relay_module_items[id].fw_start + 1000 * RELAY_FLOOD_WINDOW;
+        uint32_t fw_elapsed = current_time - relay_module_items[id].fw_start;
         unsigned long delay = set_status ? relay_module_items[id].delay_on : relay_module_items[id].delay_off;
+        unsigned long change_time = current_time + delay;
 
         relay_module_items[id].fw_count++;
-        relay_module_items[id].change_time = current_time + delay;
 
         // If current_time is off-limits the floodWindow...
-        if (current_time < relay_module_items[id].fw_start || fw_end <= current_time) {
+        if (fw_elapsed >= 1000UL * RELAY_FLOOD_WINDOW) {
             // We reset the floodWindow
             relay_module_items[id].fw_start = current_time;
             relay_module_items[id].fw_count = 1;
@@ -247,23 +578,19 @@ bool relayStatus(
         } else if (relay_module_items[id].fw_count >= RELAY_FLOOD_CHANGES) {
             // We schedule the changes to the end of the floodWindow
             // unless it's already delayed beyond that point
-            if (fw_end - delay > current_time) {
-                relay_module_items[id].change_time = fw_end;
+            if (delay < (1000UL * RELAY_FLOOD_WINDOW) - fw_elapsed) {
+                change_time = relay_module_items[id].fw_start + 1000UL * RELAY_FLOOD_WINDOW;
             }
         }
 
         relay_module_items[id].target_status = set_status;
 
+        _relayTimerSchedule(id, change_time);
+
         relaySync(id);
 
         #if DEBUG_SUPPORT
-            DPRINT(F("[RELAY] #"));
-            DPRINT(id);
-            DPRINT(F(" scheduled "));
-            DPRINT(set_status ? F("ON") : F("OFF"));
-            DPRINT(F(" in "));
-            DPRINT(relay_module_items[id].change_time - current_time);
-            DPRINT(F(" ms\n"));
+            DLOG(LOG_RELAY_CHANGE_SCHEDULED, id, set_status, relay_module_items[id].change_time - current_time);
         #endif
 
         changed = true;
@@ -335,6 +662,73 @@ void relaySync(
     _relayRecursive = false;
 }
 
+// -----------------------------------------------------------------------------
+
+/**
+ * Value was written into output register, relay is processed in next loop
+ * Observer is invoked also for same value, because repeated write could restart relay pulse
+ */
+void _relayRegisterWritten(
+    const uint8_t type,
+    const uint8_t address
+) {
+    // Relay is storing its own state
+    if (_relay_register_writing) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < RELAY_MAX_ITEMS; i++) {
+        if (relay_module_items[i].register_address == address) {
+            _relay_register_pending |= (1U << i);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+#if RELAY_SCENES_SUPPORT
+/**
+ * Switch relays which output registers are in scene mask to scene states,
+ * registers are updated & reported when relays are processed
+ */
+bool relayApplyScene(
+    const uint8_t scene
+) {
+    if (scene >= RELAY_SCENES_SIZE) {
+        return false;
+    }
+
+    uint32_t definition = 0;
+
+    if (registerReadRegister(REGISTER_TYPE_ATTRIBUTE, RELAY_SCENES_ATTR_REGISTER_START + scene, definition) == false) {
+        return false;
+    }
+
+    // 0-15     => Mask of output registers in scene
+    // 16-31    => States of output registers
+    uint16_t mask = (uint16_t) definition;
+    uint16_t states = (uint16_t) (definition >> 16);
+
+    uint8_t count = 0;
+
+    for (uint8_t i = 0; i < RELAY_MAX_ITEMS; i++) {
+        if ((mask & (1U << relay_module_items[i].register_address)) == 0) {
+            continue;
+        }
+
+        relayStatus(i, (states & (1U << relay_module_items[i].register_address)) ? RELAY_TURN_ON : RELAY_TURN_OFF);
+
+        count++;
+    }
+
+    #if DEBUG_SUPPORT
+        DLOG(LOG_RELAY_SCENE_APPLIED, scene, count);
+    #endif
+
+    return true;
+}
+#endif
+
 // -----------------------------------------------------------------------------
 // MODULE CORE
 // -----------------------------------------------------------------------------
@@ -342,13 +736,22 @@ void relaySync(
 void relaySetup()
 {
     _relayConfigure();
+
+    _relay_timer_time = millis();
+
     _relayBoot();
 
+    // Registers were restored from storage, boot mode has the precedence
+    _relay_register_pending = 0;
+
+    #if REGISTER_MAX_OUTPUT_REGISTERS_SIZE
+        registerAddObserver(REGISTER_TYPE_OUTPUT, 0, REGISTER_MAX_OUTPUT_REGISTERS_SIZE, _relayRegisterWritten, true);
+    #endif
+
     relayLoop();
 
     #if DEBUG_SUPPORT
-        DPRINT(F("[RELAY] Number of relays: "));
-        DPRINTLN(RELAY_MAX_ITEMS);
+        DLOG(LOG_RELAY_ITEMS, RELAY_MAX_ITEMS);
     #endif
 }
 
@@ -357,22 +760,35 @@ void relaySetup()
 void relayLoop()
 {
     // Process request only if device is in running mode
-    if (firmwareIsRunning()) {
-        for (uint8_t i = 0; i < RELAY_MAX_ITEMS; i++) {
+    if (firmwareIsRunning() && _relay_register_pending != 0) {
+        uint16_t pending = _relay_register_pending;
+
+        _relay_register_pending = 0;
+
+        for (uint8_t id = 0; pending != 0; id++, pending >>= 1) {
+            if ((pending & 1) == 0) {
+                continue;
+            }
+
             uint8_t expected_value = RELAY_TURN_OFF;
 
             #if REGISTER_MAX_OUTPUT_REGISTERS_SIZE
-                registerReadRegister(REGISTER_TYPE_OUTPUT, relay_module_items[i].register_address, expected_value);
+                registerReadRegister(REGISTER_TYPE_OUTPUT, relay_module_items[id].register_address, expected_value);
             #endif
 
-            if (expected_value != relayStatus(i)) {
-                relayStatus(i, expected_value);
-            }
+            relayStatus(id, expected_value);
         }
     }
 
-    _relayProcess(false);
-    _relayProcess(true);
+    _relayTimerAdvance();
+
+    if (_relay_timer_expired != 0) {
+        _relayProcessExpired();
+    }
+
+    #if RELAY_PROVIDER == RELAY_PROVIDER_RELAY
+        _relayLatchLoop();
+    #endif
 }
 
-#endif // RELAY_PROVIDER != RELAY_PROVIDER_NONE
\ No newline at end of file
+#endif // RELAY_PROVIDER != RELAY_PROVIDER_NONE
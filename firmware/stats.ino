@@ -0,0 +1,258 @@
+/*
+
+STATS MODULE
+
+Copyright (C) 2022 FastyBird s.r.o. <code@fastybird.com>
+
+*/
+
+#if STATS_SUPPORT
+
+#include "config/all.h"
+
+#include <Arduino.h>
+
+// Loop period of current publishing window
+uint32_t _stats_loop_start = 0;
+uint32_t _stats_loop_min = 0;
+uint32_t _stats_loop_max = 0;
+uint32_t _stats_loop_count = 0;
+
+// Loop periods counts in log2 buckets since boot
+uint32_t _stats_loop_histogram[STATS_LOOP_HISTOGRAM_SIZE];
+
+// Time spent in modules loops of current publishing window
+uint32_t _stats_module_start = 0;
+uint32_t _stats_module_time[STATS_MODULES_SIZE];
+
+// Events counters since boot
+uint32_t _stats_counters[STATS_COUNTERS_SIZE];
+
+// Modules loops which exceeded their time budget since boot
+uint32_t _stats_module_overruns[STATS_MODULES_SIZE];
+
+uint32_t _stats_window_start = 0;
+
+// -----------------------------------------------------------------------------
+// MODULE PRIVATE
+// -----------------------------------------------------------------------------
+
+/**
+ * Loop period is counted into bucket by its highest bit, first bucket is holding all shorter periods
+ */
+uint8_t _statsHistogramBucket(
+    uint32_t period
+) {
+    uint8_t bucket = 0;
+
+    period = period >> STATS_LOOP_HISTOGRAM_SHIFT;
+
+    while (period > 1 && bucket < (STATS_LOOP_HISTOGRAM_SIZE - 1)) {
+        period = period >> 1;
+
+        bucket++;
+    }
+
+    return bucket;
+}
+
+// -----------------------------------------------------------------------------
+
+void _statsPublishValue(
+    const uint8_t index,
+    const uint32_t value
+) {
+    // Stats are refreshed every window, regular write would flood debug log with registers changes and bus with reports
+    registerStoreRegister(REGISTER_TYPE_ATTRIBUTE, STATS_ATTR_REGISTER_START + index, value);
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Copy collected values into attribute registers, so master could read them with other registers
+ */
+void _statsPublish(
+    const uint32_t windowLength
+) {
+    uint8_t index = 0;
+
+    _statsPublishValue(index++, _stats_loop_min);
+    _statsPublishValue(index++, _stats_loop_count > 0 ? (windowLength / _stats_loop_count) : 0);
+    _statsPublishValue(index++, _stats_loop_max);
+
+    for (uint8_t i = 0; i < STATS_LOOP_HISTOGRAM_SIZE; i++) {
+        _statsPublishValue(index++, _stats_loop_histogram[i]);
+    }
+
+    for (uint8_t i = 0; i < STATS_MODULES_SIZE; i++) {
+        _statsPublishValue(index++, _stats_loop_count > 0 ? (_stats_module_time[i] / _stats_loop_count) : 0);
+
+        _stats_module_time[i] = 0;
+    }
+
+    for (uint8_t i = 0; i < STATS_COUNTERS_SIZE; i++) {
+        _statsPublishValue(index++, _stats_counters[i]);
+    }
+
+    for (uint8_t i = 0; i < STATS_MODULES_SIZE; i++) {
+        _statsPublishValue(index++, _stats_module_overruns[i]);
+    }
+
+    _stats_loop_min = 0;
+    _stats_loop_max = 0;
+    _stats_loop_count = 0;
+}
+
+// -----------------------------------------------------------------------------
+// MODULE API
+// -----------------------------------------------------------------------------
+
+/**
+ * Time since previous mark is accounted to given module, modules loops are measured one after another
+ */
+void statsModuleFinished(
+    const uint8_t module
+) {
+    uint32_t now = micros();
+
+    if (module < STATS_MODULES_SIZE) {
+        _stats_module_time[module] += now - _stats_module_start;
+    }
+
+    _stats_module_start = now;
+}
+
+// -----------------------------------------------------------------------------
+
+void statsModuleOverrun(
+    const uint8_t module
+) {
+    if (module < STATS_MODULES_SIZE) {
+        _stats_module_overruns[module]++;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void statsIncrement(
+    const uint8_t counter
+) {
+    if (counter < STATS_COUNTERS_SIZE) {
+        _stats_counters[counter]++;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Result of packet transmission as returned by PJON
+ */
+void statsPacketSent(
+    const uint16_t result
+) {
+    if (result == PJON_ACK) {
+        statsIncrement(STATS_COUNTER_TX_ACK);
+
+    } else if (result == PJON_BUSY) {
+        statsIncrement(STATS_COUNTER_TX_BUSY);
+
+    } else {
+        statsIncrement(STATS_COUNTER_TX_FAIL);
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void statsPacketHandled(
+    const uint8_t packetId
+) {
+    switch (packetId)
+    {
+        case COMMUNICATION_PACKET_PING:
+            statsIncrement(STATS_COUNTER_RX_PING);
+            break;
+
+        case COMMUNICATION_PACKET_DISCOVER:
+            statsIncrement(STATS_COUNTER_RX_DISCOVER);
+            break;
+
+        case COMMUNICATION_PACKET_READ_SINGLE_REGISTER_VALUES:
+        case COMMUNICATION_PACKET_READ_MULTIPLE_REGISTERS_VALUES:
+            statsIncrement(STATS_COUNTER_RX_READ);
+            break;
+
+        case COMMUNICATION_PACKET_WRITE_SINGLE_REGISTER_VALUE:
+        case COMMUNICATION_PACKET_WRITE_MULTIPLE_REGISTERS_VALUES:
+            statsIncrement(STATS_COUNTER_RX_WRITE);
+            break;
+
+        case COMMUNICATION_PACKET_READ_SINGLE_REGISTER_STRUCTURE:
+        case COMMUNICATION_PACKET_READ_MULTIPLE_REGISTER_STRUCTURE:
+            statsIncrement(STATS_COUNTER_RX_STRUCTURE);
+            break;
+
+        case COMMUNICATION_PACKET_SUBSCRIBE_REGISTERS:
+            statsIncrement(STATS_COUNTER_RX_SUBSCRIBE);
+            break;
+
+        case COMMUNICATION_PACKET_REPORT_ACKNOWLEDGE:
+            statsIncrement(STATS_COUNTER_RX_ACKNOWLEDGE);
+            break;
+
+        default:
+            statsIncrement(STATS_COUNTER_RX_OTHER);
+            break;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// MODULE CORE
+// -----------------------------------------------------------------------------
+
+void statsSetup()
+{
+    memset(_stats_loop_histogram, 0, sizeof(_stats_loop_histogram));
+    memset(_stats_module_time, 0, sizeof(_stats_module_time));
+    memset(_stats_counters, 0, sizeof(_stats_counters));
+    memset(_stats_module_overruns, 0, sizeof(_stats_module_overruns));
+
+    _stats_loop_start = micros();
+    _stats_module_start = _stats_loop_start;
+    _stats_window_start = millis();
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Has to be called at the beginning of main loop, period is measured between two calls
+ */
+void statsLoop()
+{
+    uint32_t now = micros();
+    uint32_t period = now - _stats_loop_start;
+
+    _stats_loop_start = now;
+    _stats_module_start = now;
+
+    if (_stats_loop_count == 0 || period < _stats_loop_min) {
+        _stats_loop_min = period;
+    }
+
+    if (period > _stats_loop_max) {
+        _stats_loop_max = period;
+    }
+
+    _stats_loop_count++;
+
+    _stats_loop_histogram[_statsHistogramBucket(period)]++;
+
+    uint32_t window_length = millis() - _stats_window_start;
+
+    if (window_length >= STATS_PUBLISH_INTERVAL) {
+        _stats_window_start = millis();
+
+        _statsPublish(window_length * 1000);
+    }
+}
+
+#endif // STATS_SUPPORT
@@ -23,50 +23,141 @@
 #include "Arduino.h"
 #include "Samd21Eeprom.h"
 
-FlashStorage(my_flash_ptr, EEPROM_EMULATION); 
+// Same storage as FlashStorage() macro, but rows are accessed separately
+__attribute__((__aligned__(EEPROM_EMULATION_ROW_SIZE)))
+static const uint8_t eeprom_flash_data[EEPROM_EMULATION_ROWS * EEPROM_EMULATION_ROW_SIZE] = { };
+
+FlashClass eeprom_flash(eeprom_flash_data, sizeof(EEPROM_EMULATION));
 
 EEPROMClass::EEPROMClass(void) {
-  _dirty = false;
+  _initialized = false;
+  _dirty_rows = 0;
+  _last_change = 0;
+  _last_commit = 0;
   _eeprom.valid = false;  
 
 
-  _flash = &my_flash_ptr;
+  _flash = &eeprom_flash;
 }
 
 uint8_t EEPROMClass::read(int address)
 {
+  if (address < 0 || address >= EEPROM_EMULATION_SIZE) {
+    return 0xFF;
+  }
+
+  init();
+
   return _eeprom.data[address]; 
 }
 
 void EEPROMClass::write(int address, uint8_t value)
 {
-  _dirty = true;
+  if (address < 0 || address >= EEPROM_EMULATION_SIZE) {
+    return;
+  }
+
+  init();
+
   _eeprom.data[address] = value; 
+
+  _dirty_rows |= (1UL << (address / EEPROM_EMULATION_ROW_SIZE));
+  _last_change = millis();
 }
 
 void EEPROMClass::update(int address, uint8_t value)
 {
-  _eeprom.data[address] = value; 
+  if (read(address) != value) {
+    write(address, value);
+  }
+}
+
+uint16_t EEPROMClass::length()
+{
+  return EEPROM_EMULATION_SIZE;
 }
 
 void EEPROMClass::init()
 {
-  _eeprom = _flash->read();
+  if (_initialized) {
+    return;
+  }
+
+  _flash->read(&_eeprom);
+
+  // Never written flash behaves like erased EEPROM
+  if (!_eeprom.valid) {
+    memset(_eeprom.data, 0xFF, EEPROM_EMULATION_SIZE);
+  }
+
+  _initialized = true;
 }
 
 bool EEPROMClass::isValid()
 {
+  init();
+
   return _eeprom.valid;
 }
 
+bool EEPROMClass::isDirty()
+{
+  return _dirty_rows != 0;
+}
+
+void EEPROMClass::commitRow(uint8_t row)
+{
+  // Valid flag is stored in the last row, it has to be written with the first commit
+  if (!_eeprom.valid) {
+    _eeprom.valid = true;
+    _dirty_rows |= (1UL << (EEPROM_EMULATION_ROWS - 1));
+  }
+
+  uint32_t offset = row * EEPROM_EMULATION_ROW_SIZE;
+  uint32_t size = sizeof(EEPROM_EMULATION) - offset;
+
+  if (size > EEPROM_EMULATION_ROW_SIZE) {
+    size = EEPROM_EMULATION_ROW_SIZE;
+  }
+
+  _flash->erase(&eeprom_flash_data[offset], size);
+  _flash->write(&eeprom_flash_data[offset], ((const uint8_t *) &_eeprom) + offset, size);
+
+  _dirty_rows &= ~(1UL << row);
+  _last_commit = millis();
+}
+
 void EEPROMClass::commit()
 {
-  if (_dirty) {
-    _eeprom.valid=true;
-    _flash->write(_eeprom);
+  for (uint8_t row = 0; row < EEPROM_EMULATION_ROWS; row++) {
+    if (_dirty_rows & (1UL << row)) {
+      commitRow(row);
+    }
   }
 }
 
+bool EEPROMClass::commitDeferred(uint32_t quietPeriod)
+{
+  if (_dirty_rows == 0) {
+    return false;
+  }
+
+  // Rows are erased one by one, each after its own quiet window
+  if ((millis() - _last_change) < quietPeriod || (millis() - _last_commit) < quietPeriod) {
+    return false;
+  }
+
+  for (uint8_t row = 0; row < EEPROM_EMULATION_ROWS; row++) {
+    if (_dirty_rows & (1UL << row)) {
+      commitRow(row);
+
+      return true;
+    }
+  }
+
+  return false;
+}
+
 EEPROMClass EEPROM;
 
-#endif
\ No newline at end of file
+#endif
@@ -29,11 +29,15 @@
 #define EEPROM_EMULATION_SIZE 1024
 #endif
 
+// Smallest erasable flash unit of SAMD21 (4 pages of 64 bytes)
+#define EEPROM_EMULATION_ROW_SIZE 256
+
 typedef struct {
   byte data[EEPROM_EMULATION_SIZE];
   boolean valid;  
 } EEPROM_EMULATION;
 
+#define EEPROM_EMULATION_ROWS ((sizeof(EEPROM_EMULATION) + EEPROM_EMULATION_ROW_SIZE - 1) / EEPROM_EMULATION_ROW_SIZE)
 
 class EEPROMClass {
 
@@ -42,14 +46,23 @@ class EEPROMClass {
     uint8_t read(int);
     void write(int, uint8_t);
     void update(int, uint8_t);
+    uint16_t length();
     bool isValid();
     void init();
     void commit();
+    // Commit one dirty row when there was no change for quietPeriod ms
+    bool commitDeferred(uint32_t quietPeriod);
+    bool isDirty();
 
   protected:
+    void commitRow(uint8_t row);
+
     EEPROM_EMULATION _eeprom;
-    bool _dirty;
-    FlashStorageClass<EEPROM_EMULATION> *_flash;
+    bool _initialized;
+    uint32_t _dirty_rows;
+    uint32_t _last_change;
+    uint32_t _last_commit;
+    FlashClass *_flash;
 
 };
 
@@ -0,0 +1,323 @@
+/*
+
+NATIVE ARDUINO CORE SHIM
+
+Copyright (C) 2022 FastyBird s.r.o. <code@fastybird.com>
+
+*/
+
+#include "Arduino.h"
+
+#include <chrono>
+
+std::chrono::steady_clock::time_point _native_clock_start = std::chrono::steady_clock::now();
+
+bool _native_clock_frozen = false;
+
+unsigned long long _native_clock_offset_us = 0;
+unsigned long long _native_clock_delayed_us = 0;
+
+uint8_t _native_pins_mode[NATIVE_PINS_COUNT];
+uint8_t _native_pins_input[NATIVE_PINS_COUNT];
+uint8_t _native_pins_output[NATIVE_PINS_COUNT];
+
+// Pins levels grouped into ports, kept in sync with pins
+volatile uint8_t _native_ports_input[NATIVE_PINS_COUNT / NATIVE_PORT_WIDTH];
+
+bool _native_serial_muted = false;
+
+HardwareSerial Serial;
+HardwareSerial Serial1;
+
+// -----------------------------------------------------------------------------
+// TIME
+// -----------------------------------------------------------------------------
+
+unsigned long long _nativeClockMicros()
+{
+    unsigned long long elapsed = 0;
+
+    if (_native_clock_frozen == false) {
+        elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _native_clock_start).count();
+    }
+
+    return elapsed + _native_clock_offset_us;
+}
+
+// -----------------------------------------------------------------------------
+
+unsigned long millis()
+{
+    // Device millis() is 32 bit wide and overflows every ~49 days
+    return (uint32_t) (_nativeClockMicros() / 1000);
+}
+
+// -----------------------------------------------------------------------------
+
+unsigned long micros()
+{
+    return (uint32_t) _nativeClockMicros();
+}
+
+// -----------------------------------------------------------------------------
+
+void delay(unsigned long ms)
+{
+    _native_clock_offset_us += (unsigned long long) ms * 1000;
+    _native_clock_delayed_us += (unsigned long long) ms * 1000;
+}
+
+// -----------------------------------------------------------------------------
+
+void delayMicroseconds(unsigned int us)
+{
+    _native_clock_offset_us += us;
+    _native_clock_delayed_us += us;
+}
+
+// -----------------------------------------------------------------------------
+
+void nativeClockFreeze(
+    const bool freeze
+) {
+    if (freeze == _native_clock_frozen) {
+        return;
+    }
+
+    // Keep time continuous when switching the clock source
+    unsigned long long now = _nativeClockMicros();
+
+    _native_clock_frozen = freeze;
+    _native_clock_start = std::chrono::steady_clock::now();
+    _native_clock_offset_us = now;
+}
+
+// -----------------------------------------------------------------------------
+
+void nativeClockAdvance(
+    const unsigned long ms
+) {
+    _native_clock_offset_us += (unsigned long long) ms * 1000;
+}
+
+// -----------------------------------------------------------------------------
+
+unsigned long nativeClockDelayed()
+{
+    return (unsigned long) (_native_clock_delayed_us / 1000);
+}
+
+// -----------------------------------------------------------------------------
+// GPIO
+// -----------------------------------------------------------------------------
+
+void _nativePortUpdate(
+    const uint8_t pin
+) {
+    if (digitalRead(pin) == HIGH) {
+        _native_ports_input[pin / NATIVE_PORT_WIDTH] |= digitalPinToBitMask(pin);
+
+    } else {
+        _native_ports_input[pin / NATIVE_PORT_WIDTH] &= ~digitalPinToBitMask(pin);
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    if (pin >= NATIVE_PINS_COUNT) {
+        return;
+    }
+
+    _native_pins_mode[pin] = mode;
+
+    if (mode == INPUT_PULLUP) {
+        _native_pins_input[pin] = HIGH;
+    }
+
+    _nativePortUpdate(pin);
+}
+
+// -----------------------------------------------------------------------------
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+    if (pin >= NATIVE_PINS_COUNT) {
+        return;
+    }
+
+    _native_pins_output[pin] = value ? HIGH : LOW;
+
+    _nativePortUpdate(pin);
+}
+
+// -----------------------------------------------------------------------------
+
+int digitalRead(uint8_t pin)
+{
+    if (pin >= NATIVE_PINS_COUNT) {
+        return LOW;
+    }
+
+    return _native_pins_mode[pin] == OUTPUT ? _native_pins_output[pin] : _native_pins_input[pin];
+}
+
+// -----------------------------------------------------------------------------
+
+uint8_t digitalPinToPort(uint8_t pin)
+{
+    if (pin >= NATIVE_PINS_COUNT) {
+        return NOT_A_PORT;
+    }
+
+    return (pin / NATIVE_PORT_WIDTH) + 1;
+}
+
+// -----------------------------------------------------------------------------
+
+uint8_t digitalPinToBitMask(uint8_t pin)
+{
+    return 1 << (pin % NATIVE_PORT_WIDTH);
+}
+
+// -----------------------------------------------------------------------------
+
+volatile uint8_t * portInputRegister(uint8_t port)
+{
+    if (port == NOT_A_PORT || port > (NATIVE_PINS_COUNT / NATIVE_PORT_WIDTH)) {
+        return NULL;
+    }
+
+    return &_native_ports_input[port - 1];
+}
+
+// -----------------------------------------------------------------------------
+
+void nativePinWrite(
+    const uint8_t pin,
+    const uint8_t value
+) {
+    if (pin >= NATIVE_PINS_COUNT) {
+        return;
+    }
+
+    _native_pins_input[pin] = value ? HIGH : LOW;
+
+    _nativePortUpdate(pin);
+}
+
+// -----------------------------------------------------------------------------
+
+uint8_t nativePinRead(
+    const uint8_t pin
+) {
+    if (pin >= NATIVE_PINS_COUNT) {
+        return LOW;
+    }
+
+    return _native_pins_output[pin];
+}
+
+// -----------------------------------------------------------------------------
+// SERIAL
+// -----------------------------------------------------------------------------
+
+void nativeSerialMute(
+    const bool mute
+) {
+    _native_serial_muted = mute;
+}
+
+// -----------------------------------------------------------------------------
+
+void HardwareSerial::begin(unsigned long baudrate) {}
+int HardwareSerial::available() { return 0; }
+int HardwareSerial::availableForWrite() { return NATIVE_SERIAL_TX_FREE; }
+int HardwareSerial::read() { return -1; }
+void HardwareSerial::flush() { fflush(stdout); }
+
+// -----------------------------------------------------------------------------
+
+size_t HardwareSerial::write(uint8_t value)
+{
+    if (_native_serial_muted == false) {
+        putchar(value);
+    }
+
+    return 1;
+}
+
+// -----------------------------------------------------------------------------
+
+size_t HardwareSerial::write(const uint8_t * buffer, size_t length)
+{
+    for (size_t i = 0; i < length; i++) {
+        write(buffer[i]);
+    }
+
+    return length;
+}
+
+// -----------------------------------------------------------------------------
+
+size_t HardwareSerial::_printNumber(unsigned long value, int base)
+{
+    char buffer[sizeof(unsigned long) * 8 + 1];
+    char * pointer = &buffer[sizeof(buffer) - 1];
+
+    *pointer = '\0';
+
+    if (base < 2) {
+        base = DEC;
+    }
+
+    do {
+        char digit = value % base;
+
+        value /= base;
+
+        *--pointer = digit < 10 ? digit + '0' : digit + 'A' - 10;
+    } while (value);
+
+    return print(pointer);
+}
+
+// -----------------------------------------------------------------------------
+
+size_t HardwareSerial::print(const char * value) { return write((const uint8_t *) value, strlen(value)); }
+size_t HardwareSerial::print(char value) { return write((uint8_t) value); }
+size_t HardwareSerial::print(unsigned char value, int base) { return _printNumber(value, base); }
+size_t HardwareSerial::print(unsigned int value, int base) { return _printNumber(value, base); }
+size_t HardwareSerial::print(unsigned long value, int base) { return _printNumber(value, base); }
+size_t HardwareSerial::print(int value, int base) { return print((long) value, base); }
+
+size_t HardwareSerial::print(long value, int base)
+{
+    if (base == DEC && value < 0) {
+        return print('-') + _printNumber((unsigned long) -value, base);
+    }
+
+    return _printNumber((unsigned long) value, base);
+}
+
+size_t HardwareSerial::print(double value, int digits)
+{
+    char buffer[32];
+
+    snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+
+    return print(buffer);
+}
+
+// -----------------------------------------------------------------------------
+
+size_t HardwareSerial::println() { return print('\n'); }
+size_t HardwareSerial::println(const char * value) { return print(value) + println(); }
+size_t HardwareSerial::println(char value) { return print(value) + println(); }
+size_t HardwareSerial::println(unsigned char value, int base) { return print(value, base) + println(); }
+size_t HardwareSerial::println(int value, int base) { return print(value, base) + println(); }
+size_t HardwareSerial::println(unsigned int value, int base) { return print(value, base) + println(); }
+size_t HardwareSerial::println(long value, int base) { return print(value, base) + println(); }
+size_t HardwareSerial::println(unsigned long value, int base) { return print(value, base) + println(); }
+size_t HardwareSerial::println(double value, int digits) { return print(value, digits) + println(); }
@@ -0,0 +1,153 @@
+/*
+
+NATIVE ARDUINO CORE SHIM
+
+Copyright (C) 2022 FastyBird s.r.o. <code@fastybird.com>
+
+Minimal subset of the Arduino core API used by the firmware, so the sketch
+could be compiled and profiled on the host (PlatformIO native platform).
+
+Time is virtual: it follows the host monotonic clock, and every delay() call
+advances it without sleeping, so blocking code is accounted in millis() but
+does not slow the benchmark down.
+
+*/
+
+#pragma once
+
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// =============================================================================
+// TYPES & CONSTANTS
+// =============================================================================
+
+typedef uint16_t word;
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH                0x1
+#define LOW                 0x0
+
+#define INPUT               0x0
+#define OUTPUT              0x1
+#define INPUT_PULLUP        0x2
+
+#define CHANGE              1
+#define FALLING             2
+#define RISING              3
+
+#define DEC                 10
+#define HEX                 16
+
+#define A0                  14
+#define A1                  15
+#define A2                  16
+#define A3                  17
+#define A4                  18
+#define A5                  19
+#define A6                  20
+#define A7                  21
+
+#define NATIVE_PINS_COUNT   64
+#define NATIVE_PORT_WIDTH   8           // Pins are grouped into 8 bit ports like on AVR
+#define NATIVE_SERIAL_TX_FREE   63      // Free space of AVR serial transmit buffer, host output is not blocking
+
+#define NOT_A_PORT          0
+
+#define F(string_literal)   (string_literal)
+
+#define PROGMEM
+#define pgm_read_byte(address)      (*(const uint8_t *) (address))
+#define pgm_read_word(address)      (*(const uint16_t *) (address))
+#define pgm_read_dword(address)     (*(const uint32_t *) (address))
+#define pgm_read_ptr(address)       (*(void * const *) (address))
+#define memcpy_P                    memcpy
+#define strlen_P                    strlen
+
+// =============================================================================
+// CORE API
+// =============================================================================
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+uint8_t digitalPinToPort(uint8_t pin);
+uint8_t digitalPinToBitMask(uint8_t pin);
+volatile uint8_t * portInputRegister(uint8_t port);
+
+// =============================================================================
+// SERIAL
+// =============================================================================
+
+class HardwareSerial {
+
+    public:
+        void begin(unsigned long baudrate);
+        int available();
+        int availableForWrite();
+        int read();
+        void flush();
+
+        size_t write(uint8_t value);
+        size_t write(const uint8_t * buffer, size_t length);
+
+        size_t print(const char * value);
+        size_t print(char value);
+        size_t print(unsigned char value, int base = DEC);
+        size_t print(int value, int base = DEC);
+        size_t print(unsigned int value, int base = DEC);
+        size_t print(long value, int base = DEC);
+        size_t print(unsigned long value, int base = DEC);
+        size_t print(double value, int digits = 2);
+
+        size_t println();
+        size_t println(const char * value);
+        size_t println(char value);
+        size_t println(unsigned char value, int base = DEC);
+        size_t println(int value, int base = DEC);
+        size_t println(unsigned int value, int base = DEC);
+        size_t println(long value, int base = DEC);
+        size_t println(unsigned long value, int base = DEC);
+        size_t println(double value, int digits = 2);
+
+    protected:
+        size_t _printNumber(unsigned long value, int base);
+
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+
+// =============================================================================
+// HOST CONTROL API
+// =============================================================================
+
+// Stop following the host clock, time moves only through delay() and nativeClockAdvance()
+void nativeClockFreeze(const bool freeze);
+// Move virtual time forward
+void nativeClockAdvance(const unsigned long ms);
+// Total time spent inside delay() calls (time the device loop would be stalled)
+unsigned long nativeClockDelayed();
+
+// Set level of input pin as seen by digitalRead()
+void nativePinWrite(const uint8_t pin, const uint8_t value);
+// Get level of output pin as set by digitalWrite()
+uint8_t nativePinRead(const uint8_t pin);
+
+// Do not forward serial output to the host stdout
+void nativeSerialMute(const bool mute);
+
+#endif
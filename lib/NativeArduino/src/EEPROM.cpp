@@ -0,0 +1,84 @@
+/*
+
+NATIVE EEPROM SHIM
+
+Copyright (C) 2022 FastyBird s.r.o. <code@fastybird.com>
+
+*/
+
+#include "EEPROM.h"
+
+EEPROMClass::EEPROMClass(void) {
+    erase();
+}
+
+uint8_t EEPROMClass::read(int address)
+{
+    if (address < 0 || address >= NATIVE_EEPROM_SIZE) {
+        return 0xFF;
+    }
+
+    return _data[address];
+}
+
+void EEPROMClass::write(int address, uint8_t value)
+{
+    if (address < 0 || address >= NATIVE_EEPROM_SIZE) {
+        return;
+    }
+
+    _data[address] = value;
+
+    _cell_writes[address]++;
+    _writes++;
+}
+
+void EEPROMClass::update(int address, uint8_t value)
+{
+    if (read(address) != value) {
+        write(address, value);
+    }
+}
+
+uint16_t EEPROMClass::length()
+{
+    return NATIVE_EEPROM_SIZE;
+}
+
+void EEPROMClass::erase()
+{
+    // Erased cells are read as 0xFF like on the device
+    memset(_data, 0xFF, NATIVE_EEPROM_SIZE);
+    memset(_cell_writes, 0, sizeof(_cell_writes));
+
+    _writes = 0;
+}
+
+uint32_t EEPROMClass::writes()
+{
+    return _writes;
+}
+
+uint32_t EEPROMClass::cellWrites(int address)
+{
+    if (address < 0 || address >= NATIVE_EEPROM_SIZE) {
+        return 0;
+    }
+
+    return _cell_writes[address];
+}
+
+uint32_t EEPROMClass::maxCellWrites()
+{
+    uint32_t max_writes = 0;
+
+    for (int i = 0; i < NATIVE_EEPROM_SIZE; i++) {
+        if (_cell_writes[i] > max_writes) {
+            max_writes = _cell_writes[i];
+        }
+    }
+
+    return max_writes;
+}
+
+EEPROMClass EEPROM;
@@ -0,0 +1,46 @@
+/*
+
+NATIVE EEPROM SHIM
+
+Copyright (C) 2022 FastyBird s.r.o. <code@fastybird.com>
+
+RAM backed EEPROM with per cell wear accounting
+
+*/
+
+#pragma once
+
+#ifndef NATIVE_EEPROM_H
+#define NATIVE_EEPROM_H
+
+#include <Arduino.h>
+
+#ifndef NATIVE_EEPROM_SIZE
+#define NATIVE_EEPROM_SIZE 1024     // Same as ATmega328
+#endif
+
+class EEPROMClass {
+
+    public:
+        EEPROMClass(void);
+        uint8_t read(int address);
+        void write(int address, uint8_t value);
+        void update(int address, uint8_t value);
+        uint16_t length();
+
+        // Host helpers
+        void erase();
+        uint32_t writes();
+        uint32_t cellWrites(int address);
+        uint32_t maxCellWrites();
+
+    protected:
+        uint8_t _data[NATIVE_EEPROM_SIZE];
+        uint32_t _cell_writes[NATIVE_EEPROM_SIZE];
+        uint32_t _writes;
+
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
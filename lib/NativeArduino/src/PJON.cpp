@@ -0,0 +1,128 @@
+/*
+
+NATIVE PJON SHIM
+
+Copyright (C) 2022 FastyBird s.r.o. <code@fastybird.com>
+
+*/
+
+#include "PJON.h"
+
+native_bus_frame_t _native_bus_queue[NATIVE_BUS_QUEUE_SIZE];
+
+uint8_t _native_bus_queue_head = 0;
+uint8_t _native_bus_queue_count = 0;
+
+NativeBusTransmitHandler _native_bus_transmit_handler = NULL;
+
+uint16_t _native_bus_transmit_result = PJON_ACK;
+uint32_t _native_bus_transmitted = 0;
+
+// -----------------------------------------------------------------------------
+
+bool nativeBusInject(
+    const uint8_t senderId,
+    const uint8_t receiverId,
+    const uint8_t * payload,
+    const uint16_t length
+) {
+    if (_native_bus_queue_count >= NATIVE_BUS_QUEUE_SIZE || length > NATIVE_BUS_FRAME_MAX_LENGTH) {
+        return false;
+    }
+
+    native_bus_frame_t * frame = &_native_bus_queue[(_native_bus_queue_head + _native_bus_queue_count) % NATIVE_BUS_QUEUE_SIZE];
+
+    frame->sender_id = senderId;
+    frame->receiver_id = receiverId;
+    frame->length = length;
+
+    memcpy(frame->content, payload, length);
+
+    _native_bus_queue_count++;
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool nativeBusFetch(
+    native_bus_frame_t &frame
+) {
+    if (_native_bus_queue_count == 0) {
+        return false;
+    }
+
+    frame = _native_bus_queue[_native_bus_queue_head];
+
+    _native_bus_queue_head = (_native_bus_queue_head + 1) % NATIVE_BUS_QUEUE_SIZE;
+    _native_bus_queue_count--;
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+uint8_t nativeBusPending()
+{
+    return _native_bus_queue_count;
+}
+
+// -----------------------------------------------------------------------------
+
+void nativeBusFlush()
+{
+    _native_bus_queue_head = 0;
+    _native_bus_queue_count = 0;
+}
+
+// -----------------------------------------------------------------------------
+
+uint16_t nativeBusTransmit(
+    const uint8_t senderId,
+    const uint8_t receiverId,
+    const void * payload,
+    const uint16_t length
+) {
+    if (_native_bus_transmit_result != PJON_ACK) {
+        return _native_bus_transmit_result;
+    }
+
+    _native_bus_transmitted++;
+
+    if (_native_bus_transmit_handler != NULL) {
+        native_bus_frame_t frame;
+
+        frame.sender_id = senderId;
+        frame.receiver_id = receiverId;
+        frame.length = length > NATIVE_BUS_FRAME_MAX_LENGTH ? NATIVE_BUS_FRAME_MAX_LENGTH : length;
+
+        memcpy(frame.content, payload, frame.length);
+
+        _native_bus_transmit_handler(frame);
+    }
+
+    return PJON_ACK;
+}
+
+// -----------------------------------------------------------------------------
+
+void nativeBusSetTransmitHandler(
+    NativeBusTransmitHandler handler
+) {
+    _native_bus_transmit_handler = handler;
+}
+
+// -----------------------------------------------------------------------------
+
+void nativeBusSetTransmitResult(
+    const uint16_t result
+) {
+    _native_bus_transmit_result = result;
+}
+
+// -----------------------------------------------------------------------------
+
+uint32_t nativeBusTransmitted()
+{
+    return _native_bus_transmitted;
+}
@@ -0,0 +1,196 @@
+/*
+
+NATIVE PJON SHIM
+
+Copyright (C) 2022 FastyBird s.r.o. <code@fastybird.com>
+
+Subset of the PJON v12 API used by the firmware. Instead of a physical
+strategy all frames travel through an in-process bus segment, where the host
+harness plays the master role: it injects frames for the device and observes
+every frame the device transmits.
+
+*/
+
+#pragma once
+
+#ifndef NATIVE_PJON_H
+#define NATIVE_PJON_H
+
+#include <Arduino.h>
+
+// =============================================================================
+// CONSTANTS
+// =============================================================================
+
+#ifndef PJON_PACKET_MAX_LENGTH
+    #define PJON_PACKET_MAX_LENGTH      50
+#endif
+
+#define PJON_BROADCAST                  0
+#define PJON_NOT_ASSIGNED               255
+
+#define PJON_ACK                        6
+#define PJON_NAK                        21
+#define PJON_BUSY                       666
+#define PJON_FAIL                       65535
+
+#define PJON_CONNECTION_LOST            101
+#define PJON_PACKETS_BUFFER_FULL        102
+#define PJON_CONTENT_TOO_LONG           104
+
+#define PJON_TX_INFO_BIT                0B00000010
+#define PJON_ACK_REQ_BIT                0B00000100
+
+#define NATIVE_BUS_FRAME_MAX_LENGTH     255
+#define NATIVE_BUS_QUEUE_SIZE           32
+
+// =============================================================================
+// DATA STRUCTURES
+// =============================================================================
+
+typedef struct {
+    uint8_t header;
+    uint16_t id;
+    uint8_t receiver_id;
+    uint8_t receiver_bus_id[4];
+    uint8_t sender_id;
+    uint8_t sender_bus_id[4];
+    uint16_t port;
+    void * custom_pointer;
+} PJON_Packet_Info;
+
+typedef void (* PJON_Receiver)(uint8_t * payload, uint16_t length, const PJON_Packet_Info &packet_info);
+typedef void (* PJON_Error)(uint8_t code, uint16_t data, void * custom_pointer);
+
+typedef struct {
+    uint8_t sender_id;
+    uint8_t receiver_id;
+    uint16_t length;
+    uint8_t content[NATIVE_BUS_FRAME_MAX_LENGTH];
+} native_bus_frame_t;
+
+typedef void (* NativeBusTransmitHandler)(const native_bus_frame_t &frame);
+
+// =============================================================================
+// IN-PROCESS BUS SEGMENT
+// =============================================================================
+
+// Queue frame which should be delivered to the device
+bool nativeBusInject(const uint8_t senderId, const uint8_t receiverId, const uint8_t * payload, const uint16_t length);
+// Take next queued frame, used by the PJON shim
+bool nativeBusFetch(native_bus_frame_t &frame);
+// Count of frames waiting for the device
+uint8_t nativeBusPending();
+// Drop all waiting frames
+void nativeBusFlush();
+
+// Publish frame transmitted by the device, returns PJON result code
+uint16_t nativeBusTransmit(const uint8_t senderId, const uint8_t receiverId, const void * payload, const uint16_t length);
+// Observe every frame transmitted by the device
+void nativeBusSetTransmitHandler(NativeBusTransmitHandler handler);
+// Force result of transmissions (PJON_ACK, PJON_BUSY or PJON_FAIL)
+void nativeBusSetTransmitResult(const uint16_t result);
+// Count of frames transmitted by the device
+uint32_t nativeBusTransmitted();
+
+// =============================================================================
+// STRATEGY
+// =============================================================================
+
+// Frames do not leave the process, the serial port is only kept for API compatibility
+class ThroughSerialAsync {
+
+    public:
+        void set_serial(void * serial) {}
+
+};
+
+// =============================================================================
+// PJON
+// =============================================================================
+
+template<typename Strategy>
+class PJON {
+
+    public:
+        Strategy strategy;
+
+        PJON(uint8_t device_id = PJON_NOT_ASSIGNED) : _device_id(device_id) {}
+
+        void begin() {}
+
+        uint8_t device_id() { return _device_id; }
+        void set_id(uint8_t id) { _device_id = id; }
+
+        void set_receiver(PJON_Receiver receiver) { _receiver = receiver; }
+        void set_error(PJON_Error error) { _error = error; }
+        void set_custom_pointer(void * pointer) { _custom_pointer = pointer; }
+
+        void set_synchronous_acknowledge(bool state) {}
+        void set_asynchronous_acknowledge(bool state) {}
+        void set_acknowledge(bool state) {}
+        void include_sender_info(bool state) {}
+
+        uint8_t update() { return 0; }
+
+        uint16_t receive()
+        {
+            native_bus_frame_t frame;
+
+            while (nativeBusFetch(frame)) {
+                // Frames for other devices are filtered out like on the wire
+                if (frame.receiver_id != _device_id && frame.receiver_id != PJON_BROADCAST) {
+                    continue;
+                }
+
+                memset(&_last_packet_info, 0, sizeof(PJON_Packet_Info));
+
+                _last_packet_info.header = PJON_TX_INFO_BIT;
+                _last_packet_info.receiver_id = frame.receiver_id;
+                _last_packet_info.sender_id = frame.sender_id;
+                _last_packet_info.custom_pointer = _custom_pointer;
+
+                if (_receiver != NULL) {
+                    _receiver(frame.content, frame.length, _last_packet_info);
+                }
+
+                return PJON_ACK;
+            }
+
+            return PJON_FAIL;
+        }
+
+        uint16_t send_packet(uint8_t id, const void * payload, uint16_t length)
+        {
+            if (length + _packetOverhead(length) > PJON_PACKET_MAX_LENGTH) {
+                if (_error != NULL) {
+                    _error(PJON_CONTENT_TOO_LONG, length, _custom_pointer);
+                }
+
+                return PJON_FAIL;
+            }
+
+            return nativeBusTransmit(_device_id, id, payload, length);
+        }
+
+        uint16_t reply(const void * payload, uint16_t length)
+        {
+            return send_packet(_last_packet_info.sender_id, payload, length);
+        }
+
+    protected:
+        uint8_t _device_id;
+
+        PJON_Receiver _receiver = NULL;
+        PJON_Error _error = NULL;
+        void * _custom_pointer = NULL;
+
+        PJON_Packet_Info _last_packet_info;
+
+        // Local mode with sender info: receiver id, header, length, header crc,
+        // sender id and crc8 (short frames) or crc32 (longer frames)
+        uint8_t _packetOverhead(uint16_t length) { return length > 15 ? 9 : 6; }
+
+};
+
+#endif
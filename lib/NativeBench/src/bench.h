@@ -0,0 +1,77 @@
+/*
+
+NATIVE BENCHMARK
+
+Copyright (C) 2022 FastyBird s.r.o. <code@fastybird.com>
+
+*/
+
+#pragma once
+
+#ifndef NATIVE_BENCH_H
+#define NATIVE_BENCH_H
+
+#include <Arduino.h>
+#include <PJON.h>
+
+// Only constants could be shared with the firmware, board config defines storage
+#include <config/types.h>
+#include <config/general.h>
+
+#define BENCH_DEVICE_ADDRESS                10
+
+// =============================================================================
+// FIRMWARE ENTRY POINTS
+// =============================================================================
+
+void setup();
+void loop();
+
+void ledLoop();
+void communicationLoop();
+void registerLoop();
+
+// Modules which are not compiled in for every board
+void buttonLoop() __attribute__((weak));
+void expanderLoop() __attribute__((weak));
+void relayLoop() __attribute__((weak));
+
+void firmwareSetDeviceState(const uint8_t setStatus);
+void communicationSetAddress(const uint8_t address);
+void communicationCaptureFlush();
+
+void registerSetup();
+bool registerReadRegister(const uint8_t type, const uint8_t address, uint8_t &value);
+bool registerReadRegister(const uint8_t type, const uint8_t address, uint8_t * value);
+bool registerWriteRegister(const uint8_t type, const uint8_t address, const uint8_t value, const bool propagate);
+uint8_t registerGetRegistersSize(const uint8_t type);
+
+// =============================================================================
+// HELPERS
+// =============================================================================
+
+// Host monotonic time in nanoseconds
+uint64_t benchNow();
+
+// Boot the device, assign bus address and switch it into running state
+void benchBoot();
+
+// Wrap packet into protocol frame and queue it for the device
+bool benchSendToDevice(const uint8_t receiverId, const uint8_t * packet, const uint8_t length);
+
+// Simulated master polling, request is sent only on some iterations
+void benchLoopTraffic(const uint32_t iteration);
+
+// =============================================================================
+// BENCHMARKS
+// =============================================================================
+
+int benchLoop(const uint32_t iterations);
+int benchPackets(const uint32_t iterations);
+int benchJournal(const uint32_t iterations);
+int benchRegisters(const uint32_t iterations);
+int benchCapture(const uint32_t iterations);
+int benchReplay(const char * path, const bool verbose);
+int benchDecode(const char * path);
+
+#endif
@@ -0,0 +1,195 @@
+/*
+
+NATIVE BENCHMARK - DEBUG LOG DECODER
+
+Copyright (C) 2022 FastyBird s.r.o. <code@fastybird.com>
+
+Binary log records as received from device serial line are turned back into
+messages with catalog from config/log.h, it has to be same as in the firmware:
+
+    <sync> <length> <message id> <time delta varint> [<argument varint>...]
+
+Bytes outside of records (bus capture lines, noise after reset) are skipped
+
+*/
+
+#include "bench.h"
+
+#include <config/log.h>
+
+#include <vector>
+
+#define BENCH_DECODE_FORMAT(id, format) format,
+
+const char * const _bench_decode_formats[LOG_MESSAGES_SIZE] = {
+    LOG_MESSAGES(BENCH_DECODE_FORMAT)
+};
+
+#undef BENCH_DECODE_FORMAT
+
+// -----------------------------------------------------------------------------
+
+uint8_t _benchDecodeArgumentsCount(
+    const char * format
+) {
+    uint8_t count = 0;
+
+    for (const char * position = format; *position != '\0'; position++) {
+        if (position[0] == '%' && (position[1] == 'u' || position[1] == 'x')) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+// -----------------------------------------------------------------------------
+
+bool _benchDecodeVarint(
+    const uint8_t * data,
+    const uint8_t length,
+    uint8_t &position,
+    uint32_t &value
+) {
+    value = 0;
+
+    for (uint8_t shift = 0; shift < 7 * LOG_RECORD_VARINT_MAX_LENGTH && position < length; shift += 7) {
+        uint8_t byte = data[position++];
+
+        value |= (uint32_t) (byte & 0x7F) << shift;
+
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Record content is validated against catalog, so sync byte found inside other data is not taken as record
+ */
+bool _benchDecodeRecord(
+    const uint8_t * data,
+    const uint8_t length,
+    uint8_t &messageId,
+    uint32_t &delta,
+    uint32_t * arguments
+) {
+    uint8_t position = 1;
+
+    messageId = data[0];
+
+    if (messageId >= LOG_MESSAGES_SIZE || _benchDecodeVarint(data, length, position, delta) == false) {
+        return false;
+    }
+
+    uint8_t arguments_count = _benchDecodeArgumentsCount(_bench_decode_formats[messageId]);
+
+    for (uint8_t i = 0; i < arguments_count; i++) {
+        if (_benchDecodeVarint(data, length, position, arguments[i]) == false) {
+            return false;
+        }
+    }
+
+    return position == length;
+}
+
+// -----------------------------------------------------------------------------
+
+void _benchDecodePrint(
+    const uint64_t timestamp,
+    const char * format,
+    const uint32_t * arguments
+) {
+    uint8_t argument = 0;
+
+    printf("[%8u.%03u] ", (uint32_t) (timestamp / 1000), (uint32_t) (timestamp % 1000));
+
+    for (const char * position = format; *position != '\0'; position++) {
+        if (position[0] == '%' && position[1] == 'u') {
+            printf("%u", arguments[argument++]);
+
+            position++;
+
+        } else if (position[0] == '%' && position[1] == 'x') {
+            printf("0x%02X", arguments[argument++]);
+
+            position++;
+
+        } else {
+            putchar(*position);
+        }
+    }
+
+    putchar('\n');
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Decode device log recorded from serial line, timestamps are in ms since first record
+ */
+int benchDecode(
+    const char * path
+) {
+    FILE * file = fopen(path, "rb");
+
+    if (file == NULL) {
+        printf("Log %s could not be opened\n", path);
+
+        return 1;
+    }
+
+    std::vector<uint8_t> content;
+
+    int byte;
+
+    while ((byte = fgetc(file)) != EOF) {
+        content.push_back((uint8_t) byte);
+    }
+
+    fclose(file);
+
+    uint32_t decoded = 0;
+    uint32_t skipped = 0;
+    uint64_t timestamp = 0;
+
+    size_t i = 0;
+
+    while (i < content.size()) {
+        uint8_t message_id;
+        uint32_t delta;
+        uint32_t arguments[LOG_RECORD_ARGUMENTS_MAX];
+
+        if (
+            content[i] != LOG_RECORD_SYNC
+            || i + LOG_RECORD_HEADER_LENGTH > content.size()
+            || content[i + 1] == 0
+            || content[i + 1] > LOG_RECORD_MAX_LENGTH - LOG_RECORD_HEADER_LENGTH
+            || i + LOG_RECORD_HEADER_LENGTH + content[i + 1] > content.size()
+            || _benchDecodeRecord(&content[i + LOG_RECORD_HEADER_LENGTH], content[i + 1], message_id, delta, arguments) == false
+        ) {
+            skipped++;
+            i++;
+
+            continue;
+        }
+
+        // First record is starting the time line
+        timestamp += decoded > 0 ? delta : 0;
+
+        _benchDecodePrint(timestamp, _bench_decode_formats[message_id], arguments);
+
+        decoded++;
+        i += LOG_RECORD_HEADER_LENGTH + content[i + 1];
+    }
+
+    printf("\n");
+    printf("  records decoded      %u\n", decoded);
+    printf("  bytes skipped        %u\n", skipped);
+
+    return decoded > 0 ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+/*
+
+NATIVE BENCHMARK - REGISTERS JOURNAL ENDURANCE
+
+Copyright (C) 2022 FastyBird s.r.o. <code@fastybird.com>
+
+*/
+
+#include "bench.h"
+
+#include <EEPROM.h>
+
+#define BENCH_JOURNAL_CELL_ENDURANCE        100000  // Guaranteed write/erase cycles of ATmega328 EEPROM cell
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Find journal slot with newest sequence, same scan as firmware is doing on boot
+ */
+uint16_t _benchJournalNewestRecordAddress()
+{
+    uint16_t newest_address = 0;
+    uint16_t newest_sequence = 0;
+    bool is_empty = true;
+
+    for (uint8_t slot = 0; slot < REGISTER_JOURNAL_RECORDS; slot++) {
+        uint16_t record_address = REGISTER_JOURNAL_START + REGISTER_JOURNAL_HEADER_SIZE + (slot * REGISTER_JOURNAL_RECORD_SIZE);
+
+        uint8_t key = EEPROM.read(record_address + 2);
+
+        if (key == 0x00 || key >= FLASH_ADDRESSES_SIZE) {
+            continue;
+        }
+
+        uint16_t sequence = (uint16_t) EEPROM.read(record_address + 1) << 8 | (uint16_t) EEPROM.read(record_address);
+
+        if (is_empty || (int16_t) (sequence - newest_sequence) > 0) {
+            newest_sequence = sequence;
+            newest_address = record_address;
+
+            is_empty = false;
+        }
+    }
+
+    return newest_address;
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Relay output toggled over and over, each change is persisted
+ */
+int benchJournal(
+    const uint32_t iterations
+) {
+    EEPROM.erase();
+
+    benchBoot();
+
+    uint32_t boot_writes = EEPROM.writes();
+
+    // -------------------------------------------------------------------------
+    // Endurance
+    // -------------------------------------------------------------------------
+
+    uint64_t start = benchNow();
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        registerWriteRegister(REGISTER_TYPE_OUTPUT, 0, (uint8_t) (i % 2 ? RELAY_TURN_OFF : RELAY_TURN_ON), false);
+    }
+
+    uint64_t elapsed = benchNow() - start;
+
+    uint32_t writes = EEPROM.writes() - boot_writes;
+    uint32_t max_cell_writes = EEPROM.maxCellWrites();
+
+    printf("Journal benchmark: %u relay toggles, %u records in journal\n", iterations, REGISTER_JOURNAL_RECORDS);
+    printf("  persisted write      %.1f ns\n", (double) elapsed / iterations);
+    printf("  EEPROM cell writes   %u (%.2f per toggle)\n", writes, (double) writes / iterations);
+    printf("  most written cell    %u writes, fixed address storage: %u writes\n", max_cell_writes, iterations);
+    printf(
+        "  toggles until worn   %.0f (fixed address storage: %u)\n",
+        (double) BENCH_JOURNAL_CELL_ENDURANCE * iterations / (max_cell_writes ? max_cell_writes : 1),
+        BENCH_JOURNAL_CELL_ENDURANCE
+    );
+
+    // -------------------------------------------------------------------------
+    // Boot recovery
+    // -------------------------------------------------------------------------
+
+    uint8_t stored_value;
+    uint8_t restored_value;
+
+    registerReadRegister(REGISTER_TYPE_OUTPUT, 0, stored_value);
+
+    start = benchNow();
+
+    registerSetup();
+
+    uint64_t scan_elapsed = benchNow() - start;
+
+    registerReadRegister(REGISTER_TYPE_OUTPUT, 0, restored_value);
+
+    printf("  boot scan            %.1f us, value %s\n", scan_elapsed / 1e3, restored_value == stored_value ? "restored" : "LOST");
+
+    // Newest record is damaged like with power loss during write
+    uint16_t torn_address = _benchJournalNewestRecordAddress();
+
+    EEPROM.write(torn_address + REGISTER_JOURNAL_RECORD_SIZE - 1, EEPROM.read(torn_address + REGISTER_JOURNAL_RECORD_SIZE - 1) ^ 0xFF);
+
+    registerSetup();
+
+    registerReadRegister(REGISTER_TYPE_OUTPUT, 0, restored_value);
+
+    printf("  torn newest record   value %s\n", restored_value != stored_value ? "rolled back to previous record" : "NOT ROLLED BACK");
+
+    return 0;
+}
@@ -0,0 +1,163 @@
+/*
+
+NATIVE BENCHMARK - LOOP THROUGHPUT
+
+Copyright (C) 2022 FastyBird s.r.o. <code@fastybird.com>
+
+*/
+
+#include "bench.h"
+
+#define BENCH_LOOP_TRAFFIC_PERIOD           100     // Master sends one request every n iterations
+#define BENCH_LOOP_MODULES_COUNT            6
+
+typedef struct {
+    const char * name;
+    void (* callback)();
+    uint64_t elapsed;
+} bench_module_t;
+
+uint32_t _bench_loop_requests = 0;
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Simulated master polling: ping, inputs & outputs reading and output writing
+ */
+void benchLoopTraffic(
+    const uint32_t iteration
+) {
+    if (iteration % BENCH_LOOP_TRAFFIC_PERIOD != 0) {
+        return;
+    }
+
+    uint8_t packet[8];
+    uint8_t length = 0;
+
+    switch (_bench_loop_requests % 4)
+    {
+        case 0:
+            packet[0] = COMMUNICATION_PACKET_PING;
+            length = 1;
+            break;
+
+        case 1:
+            packet[0] = COMMUNICATION_PACKET_READ_MULTIPLE_REGISTERS_VALUES;
+            packet[1] = REGISTER_TYPE_OUTPUT;
+            packet[2] = 0;
+            packet[3] = 0;
+            packet[4] = 0;
+            packet[5] = 4;
+            length = 6;
+            break;
+
+        case 2:
+            packet[0] = COMMUNICATION_PACKET_WRITE_SINGLE_REGISTER_VALUE;
+            packet[1] = REGISTER_TYPE_OUTPUT;
+            packet[2] = 0;
+            packet[3] = 0;
+            packet[4] = (_bench_loop_requests / 4) % 2 ? RELAY_TURN_ON : RELAY_TURN_OFF;
+            packet[5] = 0;
+            packet[6] = 0;
+            packet[7] = 0;
+            length = 8;
+            break;
+
+        case 3:
+            packet[0] = COMMUNICATION_PACKET_READ_SINGLE_REGISTER_VALUES;
+            packet[1] = REGISTER_TYPE_INPUT;
+            packet[2] = 0;
+            packet[3] = 0;
+            length = 4;
+            break;
+    }
+
+    benchSendToDevice(BENCH_DEVICE_ADDRESS, packet, length);
+
+    _bench_loop_requests++;
+}
+
+// -----------------------------------------------------------------------------
+
+int benchLoop(
+    const uint32_t iterations
+) {
+    benchBoot();
+
+    // -------------------------------------------------------------------------
+    // Whole loop() throughput
+    // -------------------------------------------------------------------------
+
+    uint32_t transmitted = nativeBusTransmitted();
+    unsigned long delayed = nativeClockDelayed();
+
+    uint64_t start = benchNow();
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        benchLoopTraffic(i);
+
+        loop();
+    }
+
+    uint64_t elapsed = benchNow() - start;
+
+    printf("Loop benchmark: %u iterations\n", iterations);
+    printf("  loop()               %.0f it/s (%.3f us per iteration)\n", iterations / (elapsed / 1e9), (elapsed / 1e3) / iterations);
+    printf("  master requests      %u\n", _bench_loop_requests);
+    printf("  device frames        %u\n", nativeBusTransmitted() - transmitted);
+    printf("  stalled in delay()   %lu ms\n", nativeClockDelayed() - delayed);
+
+    // -------------------------------------------------------------------------
+    // Per module time
+    // -------------------------------------------------------------------------
+
+    bench_module_t modules[BENCH_LOOP_MODULES_COUNT] = {
+        {"buttonLoop", buttonLoop, 0},
+        {"expanderLoop", expanderLoop, 0},
+        {"relayLoop", relayLoop, 0},
+        {"ledLoop", ledLoop, 0},
+        {"communicationLoop", communicationLoop, 0},
+        {"registerLoop", registerLoop, 0},
+    };
+
+    uint64_t total = 0;
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        benchLoopTraffic(i);
+
+        for (uint8_t j = 0; j < BENCH_LOOP_MODULES_COUNT; j++) {
+            if (modules[j].callback == NULL) {
+                continue;
+            }
+
+            start = benchNow();
+
+            modules[j].callback();
+
+            modules[j].elapsed += benchNow() - start;
+        }
+    }
+
+    for (uint8_t j = 0; j < BENCH_LOOP_MODULES_COUNT; j++) {
+        total += modules[j].elapsed;
+    }
+
+    printf("\n");
+    printf("  %-20s %12s %14s %8s\n", "module", "total [ms]", "per call [ns]", "share");
+
+    for (uint8_t j = 0; j < BENCH_LOOP_MODULES_COUNT; j++) {
+        if (modules[j].callback == NULL) {
+            continue;
+        }
+
+        printf(
+            "  %-20s %12.2f %14.1f %7.1f%%\n",
+            modules[j].name,
+            modules[j].elapsed / 1e6,
+            (double) modules[j].elapsed / iterations,
+            total ? 100.0 * modules[j].elapsed / total : 0.0
+        );
+    }
+
+    return 0;
+}
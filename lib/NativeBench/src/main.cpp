@@ -0,0 +1,123 @@
+/*
+
+NATIVE BENCHMARK
+
+Copyright (C) 2022 FastyBird s.r.o. <code@fastybird.com>
+
+Usage: program [benchmark] [iterations]
+       program replay <capture> [verbose]
+       program decode <log>
+
+    loop        loop() throughput and per module time under master traffic
+    packets     master requests handled and answered per second
+    journal     EEPROM wear and boot recovery of persisted relay toggles
+    registers   registers read & write through module API
+    capture     bus capture of simulated master traffic, needs COMMUNICATION_CAPTURE_SUPPORT
+    replay      bus capture fed into the device, handling latency & replies divergence
+    decode      binary debug log recorded from device serial line turned into messages
+
+*/
+
+#include "bench.h"
+
+#include <chrono>
+
+// -----------------------------------------------------------------------------
+// HELPERS
+// -----------------------------------------------------------------------------
+
+uint64_t benchNow()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// -----------------------------------------------------------------------------
+
+void benchBoot()
+{
+    nativeSerialMute(true);
+
+    setup();
+
+    communicationSetAddress(BENCH_DEVICE_ADDRESS);
+    firmwareSetDeviceState(DEVICE_STATE_RUNNING);
+}
+
+// -----------------------------------------------------------------------------
+
+bool benchSendToDevice(
+    const uint8_t receiverId,
+    const uint8_t * packet,
+    const uint8_t length
+) {
+    uint8_t frame[NATIVE_BUS_FRAME_MAX_LENGTH];
+
+    // 0        => Protocol version
+    // 1-n      => Packet
+    // n+1      => Packet terminator
+    frame[0] = COMMUNICATION_PROTOCOL_VERSION;
+
+    memcpy(&frame[1], packet, length);
+
+    frame[length + 1] = COMMUNICATION_PACKET_TERMINATOR;
+
+    return nativeBusInject(COMMUNICATION_BUS_MASTER_ADDR, receiverId, frame, length + 2);
+}
+
+// -----------------------------------------------------------------------------
+
+int main(
+    int argc,
+    char ** argv
+) {
+    const char * benchmark = argc > 1 ? argv[1] : "loop";
+
+    if (strcmp(benchmark, "replay") == 0) {
+        if (argc < 3) {
+            printf("Usage: %s replay <capture> [verbose]\n", argv[0]);
+
+            return 1;
+        }
+
+        return benchReplay(argv[2], argc > 3 && strcmp(argv[3], "verbose") == 0);
+    }
+
+    if (strcmp(benchmark, "decode") == 0) {
+        if (argc < 3) {
+            printf("Usage: %s decode <log>\n", argv[0]);
+
+            return 1;
+        }
+
+        return benchDecode(argv[2]);
+    }
+
+    uint32_t iterations = argc > 2 ? strtoul(argv[2], NULL, 10) : 0;
+
+    if (strcmp(benchmark, "loop") == 0) {
+        return benchLoop(iterations ? iterations : 200000);
+    }
+
+    if (strcmp(benchmark, "packets") == 0) {
+        return benchPackets(iterations ? iterations : 100000);
+    }
+
+    if (strcmp(benchmark, "journal") == 0) {
+        return benchJournal(iterations ? iterations : 1000000);
+    }
+
+    if (strcmp(benchmark, "registers") == 0) {
+        return benchRegisters(iterations ? iterations : 1000000);
+    }
+
+    if (strcmp(benchmark, "capture") == 0) {
+        return benchCapture(iterations ? iterations : 10000);
+    }
+
+    printf("Unknown benchmark: %s\n", benchmark);
+    printf("Usage: %s [loop|packets|journal|registers|capture] [iterations]\n", argv[0]);
+    printf("       %s replay <capture> [verbose]\n", argv[0]);
+    printf("       %s decode <log>\n", argv[0]);
+
+    return 1;
+}
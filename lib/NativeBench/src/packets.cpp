@@ -0,0 +1,88 @@
+/*
+
+NATIVE BENCHMARK - PACKETS THROUGHPUT
+
+Copyright (C) 2022 FastyBird s.r.o. <code@fastybird.com>
+
+*/
+
+#include "bench.h"
+
+#define BENCH_PACKETS_TYPES_COUNT           6
+
+typedef struct {
+    const char * name;
+    uint8_t packet[8];
+    uint8_t length;
+} bench_packet_t;
+
+uint32_t _bench_packets_replies = 0;
+
+// -----------------------------------------------------------------------------
+
+void _benchPacketsReplyHandler(
+    const native_bus_frame_t &frame
+) {
+    _bench_packets_replies++;
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Master requests are received and answered only by communication module
+ */
+int benchPackets(
+    const uint32_t iterations
+) {
+    benchBoot();
+
+    nativeBusSetTransmitHandler(_benchPacketsReplyHandler);
+
+    bench_packet_t packets[BENCH_PACKETS_TYPES_COUNT] = {
+        {"ping", {COMMUNICATION_PACKET_PING}, 1},
+        {"read single", {COMMUNICATION_PACKET_READ_SINGLE_REGISTER_VALUES, REGISTER_TYPE_INPUT, 0, 0}, 4},
+        {"read multiple", {COMMUNICATION_PACKET_READ_MULTIPLE_REGISTERS_VALUES, REGISTER_TYPE_OUTPUT, 0, 0, 0, 4}, 6},
+        {"read structure", {COMMUNICATION_PACKET_READ_SINGLE_REGISTER_STRUCTURE, REGISTER_TYPE_ATTRIBUTE, 0, 0}, 4},
+        {"read structures", {COMMUNICATION_PACKET_READ_MULTIPLE_REGISTER_STRUCTURE, REGISTER_TYPE_ATTRIBUTE, 0, 0, 0, REGISTER_MAX_ATTRIBUTE_REGISTERS_SIZE}, 6},
+        {"write single", {COMMUNICATION_PACKET_WRITE_SINGLE_REGISTER_VALUE, REGISTER_TYPE_OUTPUT, 0, 0, RELAY_TURN_ON, 0, 0, 0}, 8},
+    };
+
+    printf("Packets benchmark: %u packets per type\n", iterations);
+    printf("  %-20s %14s %14s %10s\n", "packet", "packets/s", "per packet [ns]", "replies");
+
+    uint32_t total_packets = 0;
+    uint64_t total_elapsed = 0;
+
+    for (uint8_t j = 0; j < BENCH_PACKETS_TYPES_COUNT; j++) {
+        _bench_packets_replies = 0;
+
+        uint64_t elapsed = 0;
+
+        for (uint32_t i = 0; i < iterations; i++) {
+            benchSendToDevice(BENCH_DEVICE_ADDRESS, packets[j].packet, packets[j].length);
+
+            uint64_t start = benchNow();
+
+            communicationLoop();
+
+            elapsed += benchNow() - start;
+        }
+
+        printf(
+            "  %-20s %14.0f %14.1f %10u\n",
+            packets[j].name,
+            iterations / (elapsed / 1e9),
+            (double) elapsed / iterations,
+            _bench_packets_replies
+        );
+
+        total_packets += iterations;
+        total_elapsed += elapsed;
+    }
+
+    printf("  %-20s %14.0f %14.1f\n", "all", total_packets / (total_elapsed / 1e9), (double) total_elapsed / total_packets);
+
+    nativeBusSetTransmitHandler(NULL);
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+/*
+
+NATIVE BENCHMARK - REGISTERS ACCESS
+
+Copyright (C) 2022 FastyBird s.r.o. <code@fastybird.com>
+
+*/
+
+#include "bench.h"
+
+#define BENCH_REGISTERS_TYPES_COUNT         3
+
+volatile uint32_t _bench_registers_sink = 0;
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Registers read & written through module API, as communication module does
+ */
+int benchRegisters(
+    const uint32_t iterations
+) {
+    benchBoot();
+
+    const uint8_t types[BENCH_REGISTERS_TYPES_COUNT] = {REGISTER_TYPE_INPUT, REGISTER_TYPE_OUTPUT, REGISTER_TYPE_ATTRIBUTE};
+    const char * names[BENCH_REGISTERS_TYPES_COUNT] = {"input", "output", "attribute"};
+
+    printf("Registers benchmark: %u accesses per type and operation\n", iterations);
+    printf("  %-12s %10s %12s %14s %14s\n", "type", "registers", "read [ns]", "read raw [ns]", "write [ns]");
+
+    for (uint8_t j = 0; j < BENCH_REGISTERS_TYPES_COUNT; j++) {
+        uint8_t size = registerGetRegistersSize(types[j]);
+
+        if (size == 0) {
+            continue;
+        }
+
+        uint8_t value = 0;
+        uint8_t raw_value[4] = {0, 0, 0, 0};
+
+        uint64_t start = benchNow();
+
+        for (uint32_t i = 0; i < iterations; i++) {
+            registerReadRegister(types[j], i % size, value);
+
+            _bench_registers_sink += value;
+        }
+
+        uint64_t read_elapsed = benchNow() - start;
+
+        start = benchNow();
+
+        for (uint32_t i = 0; i < iterations; i++) {
+            registerReadRegister(types[j], i % size, raw_value);
+
+            _bench_registers_sink += raw_value[0];
+        }
+
+        uint64_t read_raw_elapsed = benchNow() - start;
+
+        printf(
+            "  %-12s %10u %12.1f %14.1f",
+            names[j],
+            size,
+            (double) read_elapsed / iterations,
+            (double) read_raw_elapsed / iterations
+        );
+
+        // Attributes writes have side effects, e.g. device address change reboots device
+        if (types[j] == REGISTER_TYPE_ATTRIBUTE) {
+            printf(" %14s\n", "n/a");
+
+            continue;
+        }
+
+        start = benchNow();
+
+        for (uint32_t i = 0; i < iterations; i++) {
+            registerWriteRegister(types[j], i % size, (uint8_t) (i & 0x01), false);
+        }
+
+        uint64_t write_elapsed = benchNow() - start;
+
+        printf(" %14.1f\n", (double) write_elapsed / iterations);
+    }
+
+    return 0;
+}
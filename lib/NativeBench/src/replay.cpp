@@ -0,0 +1,424 @@
+/*
+
+NATIVE BENCHMARK - BUS CAPTURE & REPLAY
+
+Copyright (C) 2022 FastyBird s.r.o. <code@fastybird.com>
+
+Capture lines are streamed by the communication module when it is built with
+COMMUNICATION_CAPTURE_SUPPORT, binary debug log records in between are skipped:
+
+    @<timestamp>,<R|T>,<sender>,<receiver>,<frame in hex>
+
+*/
+
+#include "bench.h"
+
+#include <vector>
+
+#define BENCH_REPLAY_LINE_LENGTH            (32 + 2 * NATIVE_BUS_FRAME_MAX_LENGTH)
+#define BENCH_REPLAY_HANDLING_LOOPS         3       // loop() calls given to the device to answer received frame
+#define BENCH_REPLAY_DIVERGENCES_PRINTED    20
+#define BENCH_REPLAY_PACKETS_SIZE           256
+
+typedef struct {
+    uint32_t line;
+    uint32_t timestamp;
+    char direction;
+    uint8_t sender;
+    uint8_t receiver;
+    uint16_t length;
+    uint8_t content[NATIVE_BUS_FRAME_MAX_LENGTH];
+} bench_replay_record_t;
+
+typedef struct {
+    uint32_t count;
+    uint64_t elapsed;
+    uint64_t max;
+} bench_replay_latency_t;
+
+std::vector<native_bus_frame_t> _bench_replay_transmitted;
+
+uint32_t _bench_replay_divergences = 0;
+
+// -----------------------------------------------------------------------------
+
+void _benchReplayTransmitted(
+    const native_bus_frame_t &frame
+) {
+    _bench_replay_transmitted.push_back(frame);
+}
+
+// -----------------------------------------------------------------------------
+
+void _benchReplayPrintFrame(
+    const uint8_t * content,
+    const uint16_t length
+) {
+    for (uint16_t i = 0; i < length; i++) {
+        printf("%02X", content[i]);
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+uint8_t _benchReplayHexDigit(
+    const char digit
+) {
+    if (digit >= '0' && digit <= '9') {
+        return digit - '0';
+    }
+
+    if (digit >= 'A' && digit <= 'F') {
+        return digit - 'A' + 10;
+    }
+
+    if (digit >= 'a' && digit <= 'f') {
+        return digit - 'a' + 10;
+    }
+
+    return 0xFF;
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Read one line and return its part starting with last capture marker, debug log records
+ * could be written right before capture line and they could contain any byte
+ */
+const char * _benchReplayReadLine(
+    FILE * file,
+    char * line,
+    const uint16_t size
+) {
+    int character;
+
+    uint16_t length = 0;
+    int16_t marker = -1;
+
+    while ((character = fgetc(file)) != EOF && character != '\n') {
+        if (length < size - 1) {
+            if (character == COMMUNICATION_CAPTURE_MARKER[0]) {
+                marker = length;
+            }
+
+            line[length++] = (char) character;
+        }
+    }
+
+    line[length] = '\0';
+
+    if (character == EOF && length == 0) {
+        return NULL;
+    }
+
+    return marker >= 0 ? &line[marker] : "";
+}
+
+// -----------------------------------------------------------------------------
+
+bool _benchReplayParseLine(
+    const char * line,
+    bench_replay_record_t &record
+) {
+    unsigned long timestamp;
+    unsigned int sender;
+    unsigned int receiver;
+    int frame_offset = 0;
+
+    if (
+        sscanf(line, COMMUNICATION_CAPTURE_MARKER "%lu,%c,%u,%u,%n", &timestamp, &record.direction, &sender, &receiver, &frame_offset) != 4
+        || frame_offset == 0
+        || (record.direction != COMMUNICATION_CAPTURE_RECEIVED && record.direction != COMMUNICATION_CAPTURE_TRANSMITTED)
+    ) {
+        return false;
+    }
+
+    record.timestamp = (uint32_t) timestamp;
+    record.sender = (uint8_t) sender;
+    record.receiver = (uint8_t) receiver;
+    record.length = 0;
+
+    const char * frame = &line[frame_offset];
+
+    while (record.length < NATIVE_BUS_FRAME_MAX_LENGTH) {
+        uint8_t high = _benchReplayHexDigit(frame[0]);
+        uint8_t low = high == 0xFF ? 0xFF : _benchReplayHexDigit(frame[1]);
+
+        if (high == 0xFF || low == 0xFF) {
+            break;
+        }
+
+        record.content[record.length++] = (high << 4) | low;
+
+        frame += 2;
+    }
+
+    return record.length > 0;
+}
+
+// -----------------------------------------------------------------------------
+
+void _benchReplayDiverged(
+    const bench_replay_record_t * record,
+    const native_bus_frame_t * frame
+) {
+    _bench_replay_divergences++;
+
+    if (_bench_replay_divergences > BENCH_REPLAY_DIVERGENCES_PRINTED) {
+        return;
+    }
+
+    if (record != NULL) {
+        printf("  line %-8u expected ", record->line);
+        _benchReplayPrintFrame(record->content, record->length);
+        printf(" to %u\n", record->receiver);
+
+    } else {
+        printf("  %-13s expected nothing\n", "end");
+    }
+
+    printf("  %-13s      got ", "");
+
+    if (frame != NULL) {
+        _benchReplayPrintFrame(frame->content, frame->length);
+        printf(" to %u\n", frame->receiver_id);
+
+    } else {
+        printf("nothing\n");
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Stream simulated master traffic as capture, so it could be replayed against other firmware revision
+ */
+int benchCapture(
+    const uint32_t iterations
+) {
+    #if COMMUNICATION_CAPTURE_SUPPORT
+        nativeClockFreeze(true);
+
+        benchBoot();
+
+        nativeSerialMute(false);
+
+        for (uint32_t i = 0; i < iterations; i++) {
+            benchLoopTraffic(i);
+
+            loop();
+
+            nativeClockAdvance(1);
+        }
+
+        // Frames captured in last loops are still waiting for idle time
+        communicationCaptureFlush();
+
+        return 0;
+    #else
+        printf("Firmware has to be built with COMMUNICATION_CAPTURE_SUPPORT\n");
+
+        return 1;
+    #endif
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Feed received frames of capture into the device in recorded time and compare device replies
+ */
+int benchReplay(
+    const char * path,
+    const bool verbose
+) {
+    FILE * file = fopen(path, "rb");
+
+    if (file == NULL) {
+        printf("Capture %s could not be opened\n", path);
+
+        return 1;
+    }
+
+    std::vector<bench_replay_record_t> records;
+
+    char line[BENCH_REPLAY_LINE_LENGTH];
+    uint32_t line_number = 0;
+
+    bench_replay_record_t record;
+
+    const char * capture_line;
+
+    while ((capture_line = _benchReplayReadLine(file, line, sizeof(line))) != NULL) {
+        line_number++;
+
+        if (_benchReplayParseLine(capture_line, record)) {
+            record.line = line_number;
+
+            records.push_back(record);
+        }
+    }
+
+    fclose(file);
+
+    if (records.empty()) {
+        printf("Capture %s does not contain any frame\n", path);
+
+        return 1;
+    }
+
+    // Device address is taken from its first transmitted frame
+    uint8_t device_address = BENCH_DEVICE_ADDRESS;
+
+    for (size_t i = 0; i < records.size(); i++) {
+        if (records[i].direction == COMMUNICATION_CAPTURE_TRANSMITTED) {
+            device_address = records[i].sender;
+
+            break;
+        }
+    }
+
+    // Device time is following capture timestamps
+    nativeClockFreeze(true);
+
+    benchBoot();
+
+    communicationSetAddress(device_address);
+
+    nativeBusSetTransmitHandler(_benchReplayTransmitted);
+
+    _bench_replay_transmitted.clear();
+    _bench_replay_divergences = 0;
+
+    bench_replay_latency_t latencies[BENCH_REPLAY_PACKETS_SIZE];
+
+    memset(latencies, 0, sizeof(latencies));
+
+    uint32_t received_count = 0;
+    uint32_t recorded_count = 0;
+    uint64_t total_elapsed = 0;
+
+    size_t compared = 0;
+
+    unsigned long clock_start = millis();
+
+    printf("Replay benchmark: %s, %u frames, device address %u\n", path, (uint32_t) records.size(), device_address);
+
+    for (size_t i = 0; i < records.size(); i++) {
+        bench_replay_record_t * current = &records[i];
+
+        // Device is running its timers between frames as it did during capture
+        while ((uint32_t) (millis() - clock_start) < (current->timestamp - records[0].timestamp)) {
+            loop();
+
+            nativeClockAdvance(1);
+        }
+
+        if (current->direction == COMMUNICATION_CAPTURE_TRANSMITTED) {
+            recorded_count++;
+
+            // Frame transmitted by device timers, not as a reply
+            for (uint8_t j = 0; j < BENCH_REPLAY_HANDLING_LOOPS && compared >= _bench_replay_transmitted.size(); j++) {
+                loop();
+            }
+
+            if (compared >= _bench_replay_transmitted.size()) {
+                _benchReplayDiverged(current, NULL);
+
+                continue;
+            }
+
+            native_bus_frame_t * frame = &_bench_replay_transmitted[compared++];
+
+            if (
+                frame->receiver_id != current->receiver
+                || frame->length != current->length
+                || memcmp(frame->content, current->content, current->length) != 0
+            ) {
+                _benchReplayDiverged(current, frame);
+            }
+
+            continue;
+        }
+
+        // Frames of other devices on the segment are not delivered
+        if (current->receiver != device_address && current->receiver != PJON_BROADCAST) {
+            continue;
+        }
+
+        size_t transmitted_before = _bench_replay_transmitted.size();
+
+        nativeBusInject(current->sender, current->receiver, current->content, current->length);
+
+        uint64_t start = benchNow();
+        uint64_t latency = 0;
+
+        for (uint8_t j = 0; j < BENCH_REPLAY_HANDLING_LOOPS; j++) {
+            loop();
+
+            if (latency == 0 && _bench_replay_transmitted.size() > transmitted_before) {
+                latency = benchNow() - start;
+            }
+        }
+
+        // Frames without reply are accounted with whole handling time
+        if (latency == 0) {
+            latency = benchNow() - start;
+        }
+
+        uint8_t packet_id = current->length > 1 ? current->content[1] : 0;
+
+        latencies[packet_id].count++;
+        latencies[packet_id].elapsed += latency;
+
+        if (latency > latencies[packet_id].max) {
+            latencies[packet_id].max = latency;
+        }
+
+        received_count++;
+        total_elapsed += latency;
+
+        if (verbose) {
+            printf("  line %-8u packet 0x%02X %10.1f us => ", current->line, packet_id, latency / 1e3);
+
+            if (_bench_replay_transmitted.size() == transmitted_before) {
+                printf("no reply");
+            }
+
+            for (size_t j = transmitted_before; j < _bench_replay_transmitted.size(); j++) {
+                _benchReplayPrintFrame(_bench_replay_transmitted[j].content, _bench_replay_transmitted[j].length);
+                printf(" ");
+            }
+
+            printf("\n");
+        }
+    }
+
+    // Frames which were not recorded
+    while (compared < _bench_replay_transmitted.size()) {
+        _benchReplayDiverged(NULL, &_bench_replay_transmitted[compared++]);
+    }
+
+    printf("  frames replayed      %u\n", received_count);
+    printf("  frames transmitted   %u (recorded %u)\n", (uint32_t) _bench_replay_transmitted.size(), recorded_count);
+    printf("  diverged frames      %u\n", _bench_replay_divergences);
+    printf("  throughput           %.0f frames/s\n", total_elapsed ? received_count / (total_elapsed / 1e9) : 0.0);
+
+    printf("\n");
+    printf("  %-8s %10s %14s %14s\n", "packet", "frames", "avg [us]", "max [us]");
+
+    for (uint16_t i = 0; i < BENCH_REPLAY_PACKETS_SIZE; i++) {
+        if (latencies[i].count == 0) {
+            continue;
+        }
+
+        printf(
+            "  0x%02X     %10u %14.2f %14.2f\n",
+            i,
+            latencies[i].count,
+            (latencies[i].elapsed / 1e3) / latencies[i].count,
+            latencies[i].max / 1e3
+        );
+    }
+
+    return _bench_replay_divergences > 0 ? 2 : 0;
+}